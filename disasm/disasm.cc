@@ -2818,6 +2818,7 @@ void disassembler_t::add_instructions(const isa_parser_t* isa, bool strict)
 	DEFINE_UVTYPE_DP(so_v_cv_sg_h);
 	DEFINE_UVTYPE_DP(so_v_cv_sg_w);
 	DEFINE_UVTYPE_DP(so_v_cv_sg_d);
+	DEFINE_UVTYPE_DP(so_v_cv_fp_h);
 	DEFINE_UVTYPE_DP(so_v_cv_fp_w);
 	DEFINE_UVTYPE_DP(so_v_cv_fp_d);
   DEFINE_UVTYPE_MOVE(so_v_mv);
@@ -2847,6 +2848,9 @@ void disassembler_t::add_instructions(const isa_parser_t* isa, bool strict)
   DEFINE_UATYPE(so_a_mac_fp);
   DEFINE_UATYPE(so_a_mac_us);
   DEFINE_UATYPE(so_a_mac_sg);
+  DEFINE_UATYPE(so_a_mac_w_fp);
+  DEFINE_UATYPE(so_a_mac_w_us);
+  DEFINE_UATYPE(so_a_mac_w_sg);
   DEFINE_UATYPE(so_a_min_fp);
   DEFINE_UATYPE(so_a_min_us);
   DEFINE_UATYPE(so_a_min_sg);
@@ -2870,6 +2874,9 @@ void disassembler_t::add_instructions(const isa_parser_t* isa, bool strict)
   DEFINE_UA1TYPE(so_a_adde_acc_fp);
   DEFINE_UA1TYPE(so_a_adde_acc_us);
   DEFINE_UA1TYPE(so_a_adde_acc_sg);
+  DEFINE_UA1TYPE(so_a_adde_acc_w_fp);
+  DEFINE_UA1TYPE(so_a_adde_acc_w_us);
+  DEFINE_UA1TYPE(so_a_adde_acc_w_sg);
   DEFINE_UA1TYPE(so_a_mine_fp);
   DEFINE_UA1TYPE(so_a_mine_us);
   DEFINE_UA1TYPE(so_a_mine_sg);
@@ -57,6 +57,12 @@ void cache_sim_t::init()
   bytes_written = 0;
   writebacks = 0;
 
+  prefetch_distance = 0;
+  prefetch_latency = 0;
+  prefetches = 0;
+  useful_prefetches = 0;
+  late_prefetches = 0;
+
   miss_handler = NULL;
 }
 
@@ -95,6 +101,30 @@ void cache_sim_t::print_stats()
   std::cout << "Writebacks:            " << writebacks << std::endl;
   std::cout << name << " ";
   std::cout << "Miss Rate:             " << mr << '%' << std::endl;
+
+  if (prefetch_distance) {
+    std::cout << name << " ";
+    std::cout << "Prefetches:            " << prefetches << std::endl;
+    std::cout << name << " ";
+    std::cout << "Useful Prefetches:     " << useful_prefetches << std::endl;
+    std::cout << name << " ";
+    std::cout << "Late Prefetches:       " << late_prefetches << std::endl;
+    std::cout << name << " ";
+    std::cout << "Useless Prefetches:    " << prefetches - useful_prefetches - late_prefetches << std::endl;
+  }
+
+  for (auto& [stream, stats] : stream_stats) {
+    std::cout << name << " u" << std::setw(2) << std::left << stream << std::right << " ";
+    std::cout << "Read Accesses:     " << stats.read_accesses << std::endl;
+    std::cout << name << " u" << std::setw(2) << std::left << stream << std::right << " ";
+    std::cout << "Write Accesses:    " << stats.write_accesses << std::endl;
+    std::cout << name << " u" << std::setw(2) << std::left << stream << std::right << " ";
+    std::cout << "Read Misses:       " << stats.read_misses << std::endl;
+    std::cout << name << " u" << std::setw(2) << std::left << stream << std::right << " ";
+    std::cout << "Write Misses:      " << stats.write_misses << std::endl;
+    std::cout << name << " u" << std::setw(2) << std::left << stream << std::right << " ";
+    std::cout << "Writebacks:        " << stats.writebacks << std::endl;
+  }
 }
 
 uint64_t* cache_sim_t::check_tag(uint64_t addr)
@@ -103,7 +133,7 @@ uint64_t* cache_sim_t::check_tag(uint64_t addr)
   size_t tag = (addr >> idx_shift) | VALID;
 
   for (size_t i = 0; i < ways; i++)
-    if (tag == (tags[idx*ways + i] & ~DIRTY))
+    if (tag == (tags[idx*ways + i] & ~(DIRTY | PREFETCHED)))
       return &tags[idx*ways + i];
 
   return NULL;
@@ -126,6 +156,12 @@ void cache_sim_t::access(uint64_t addr, size_t bytes, bool store)
   uint64_t* hit_way = check_tag(addr);
   if (likely(hit_way != NULL))
   {
+    if (unlikely(*hit_way & PREFETCHED)) {
+      *hit_way &= ~PREFETCHED;
+      auto ready = prefetch_ready.find(addr >> idx_shift);
+      (read_accesses + write_accesses >= ready->second ? useful_prefetches : late_prefetches)++;
+      prefetch_ready.erase(ready);
+    }
     if (store)
       *hit_way |= DIRTY;
     return;
@@ -139,21 +175,102 @@ void cache_sim_t::access(uint64_t addr, size_t bytes, bool store)
               << std::hex << addr << std::endl;
   }
 
+  fill(addr);
+
+  if (store)
+    *check_tag(addr) |= DIRTY;
+}
+
+void cache_sim_t::fill(uint64_t addr)
+{
   uint64_t victim = victimize(addr);
 
   if ((victim & (VALID | DIRTY)) == (VALID | DIRTY))
   {
-    uint64_t dirty_addr = (victim & ~(VALID | DIRTY)) << idx_shift;
+    uint64_t dirty_addr = (victim & ~(VALID | DIRTY | PREFETCHED)) << idx_shift;
     if (miss_handler)
       miss_handler->access(dirty_addr, linesz, true);
     writebacks++;
   }
 
+  if (victim & PREFETCHED)
+    prefetch_ready.erase(victim & ~(VALID | DIRTY | PREFETCHED));
+
   if (miss_handler)
     miss_handler->access(addr & ~(linesz-1), linesz, false);
+}
 
-  if (store)
-    *check_tag(addr) |= DIRTY;
+void cache_sim_t::set_stream_prefetcher(size_t distance, size_t latency)
+{
+  prefetch_distance = distance;
+  prefetch_latency = latency;
+}
+
+void cache_sim_t::configure_stream(size_t stream, const stream_pattern_t* pattern)
+{
+  if (!prefetch_distance)
+    return;
+
+  prefetch_streams.erase(stream);
+  if (pattern) {
+    auto& prefetched = prefetch_streams[stream];
+    prefetched.pattern = pattern->clone();
+    prefetch(prefetched);
+  }
+}
+
+// Walks the pattern of a stream past the elements it has accessed, until the
+// next prefetch_distance lines it will access have been prefetched. Lines
+// already in the cache are not fetched again.
+void cache_sim_t::prefetch(stream_prefetch_t& stream)
+{
+  while (!stream.ahead.empty() && stream.ahead.front().second < stream.consumed)
+    stream.ahead.pop_front();
+
+  // Bounds the walk of a pattern that stays within a few lines for long
+  for (size_t budget = prefetch_distance * linesz; budget; budget--) {
+    uint64_t paddr;
+    if (!stream.pending) {
+      if (!stream.pattern->next(paddr))
+        break;
+      stream.pending = {paddr >> idx_shift, stream.walked++};
+    }
+
+    auto [line, element] = *stream.pending;
+    if (element >= stream.consumed && (stream.ahead.empty() || stream.ahead.back().first != line)) {
+      if (stream.ahead.size() >= prefetch_distance)
+        break;
+      if (!check_tag(line << idx_shift)) {
+        prefetches++;
+        fill(line << idx_shift);
+        *check_tag(line << idx_shift) |= PREFETCHED;
+        prefetch_ready[line] = read_accesses + write_accesses + prefetch_latency;
+      }
+      stream.ahead.push_back({line, element});
+    } else if (element >= stream.consumed) {
+      stream.ahead.back().second = element;
+    }
+    stream.pending.reset();
+  }
+}
+
+void cache_sim_t::access_stream(size_t stream, uint64_t addr, size_t bytes, size_t access_bytes, bool store)
+{
+  stream_stats_t& stats = stream_stats[stream];
+  for (size_t offset = 0; offset < bytes; offset += access_bytes) {
+    const uint64_t misses = store ? write_misses : read_misses;
+    const uint64_t evictions = writebacks;
+    access(addr + offset, access_bytes, store);
+    (store ? stats.write_accesses : stats.read_accesses)++;
+    (store ? stats.write_misses : stats.read_misses) += (store ? write_misses : read_misses) - misses;
+    stats.writebacks += writebacks - evictions;
+  }
+
+  auto prefetched = prefetch_streams.find(stream);
+  if (prefetched != prefetch_streams.end()) {
+    prefetched->second.consumed += bytes / access_bytes;
+    prefetch(prefetched->second);
+  }
 }
 
 void cache_sim_t::clean_invalidate(uint64_t addr, size_t bytes, bool clean, bool inval)
@@ -8,6 +8,9 @@
 #include <cstring>
 #include <string>
 #include <map>
+#include <deque>
+#include <optional>
+#include <unordered_map>
 #include <cstdint>
 
 class lfsr_t
@@ -28,16 +31,27 @@ class cache_sim_t
   virtual ~cache_sim_t();
 
   void access(uint64_t addr, size_t bytes, bool store);
+  // Accesses of `access_bytes` each over [addr, addr + bytes), made by the
+  // UVE stream held in stream register `stream`
+  void access_stream(size_t stream, uint64_t addr, size_t bytes, size_t access_bytes, bool store);
   void clean_invalidate(uint64_t addr, size_t bytes, bool clean, bool inval);
   void print_stats();
   void set_miss_handler(cache_sim_t* mh) { miss_handler = mh; }
   void set_log(bool _log) { log = _log; }
 
+  // Optional prefetcher following the patterns of UVE streams. It keeps the
+  // next `distance` lines of every stream prefetched, each of them arriving
+  // `latency` accesses after it is issued.
+  void set_stream_prefetcher(size_t distance, size_t latency);
+  void configure_stream(size_t stream, const stream_pattern_t* pattern);
+
   static cache_sim_t* construct(const char* config, const char* name);
 
  protected:
   static const uint64_t VALID = 1ULL << 63;
   static const uint64_t DIRTY = 1ULL << 62;
+  // Filled by the stream prefetcher and not accessed since
+  static const uint64_t PREFETCHED = 1ULL << 61;
 
   virtual uint64_t* check_tag(uint64_t addr);
   virtual uint64_t victimize(uint64_t addr);
@@ -60,10 +74,42 @@ class cache_sim_t
   uint64_t bytes_written;
   uint64_t writebacks;
 
+  // Share of the counters above caused by each UVE stream register, with
+  // writebacks attributed to the stream whose miss evicted the dirty line
+  struct stream_stats_t {
+    uint64_t read_accesses = 0;
+    uint64_t read_misses = 0;
+    uint64_t write_accesses = 0;
+    uint64_t write_misses = 0;
+    uint64_t writebacks = 0;
+  };
+  std::map<size_t, stream_stats_t> stream_stats;
+
+  struct stream_prefetch_t {
+    std::unique_ptr<stream_pattern_t> pattern;
+    // Lines prefetched ahead of the stream, with the index of the last
+    // element of the stream in each of them
+    std::deque<std::pair<uint64_t, uint64_t>> ahead;
+    // Next element of the pattern, once read, as its line and index
+    std::optional<std::pair<uint64_t, uint64_t>> pending;
+    uint64_t walked = 0;
+    uint64_t consumed = 0;
+  };
+  std::map<size_t, stream_prefetch_t> prefetch_streams;
+  size_t prefetch_distance;
+  size_t prefetch_latency;
+  // Access count at which each prefetched line arrives
+  std::unordered_map<uint64_t, uint64_t> prefetch_ready;
+  uint64_t prefetches;
+  uint64_t useful_prefetches;
+  uint64_t late_prefetches;
+
   std::string name;
   bool log;
 
   void init();
+  void fill(uint64_t addr);
+  void prefetch(stream_prefetch_t& stream);
 };
 
 class fa_cache_sim_t : public cache_sim_t
@@ -137,6 +183,20 @@ class dcache_sim_t : public cache_memtracer_t
   {
     if (type == LOAD || type == STORE) cache->access(addr, bytes, type == STORE);
   }
+  void trace_stream(size_t stream, const std::vector<memtrace_range_t>& ranges, access_type type)
+  {
+    if (type == LOAD || type == STORE)
+      for (auto& r : ranges)
+        cache->access_stream(stream, r.addr, r.bytes, r.access_bytes, type == STORE);
+  }
+  void stream_configured(size_t stream, const stream_pattern_t* pattern)
+  {
+    cache->configure_stream(stream, pattern);
+  }
+  void set_stream_prefetcher(size_t distance, size_t latency)
+  {
+    cache->set_stream_prefetcher(distance, latency);
+  }
 };
 
 #endif
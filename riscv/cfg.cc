@@ -48,4 +48,8 @@ cfg_t::cfg_t()
   real_time_clint  = false;
   trigger_count    = 4;
   cache_blocksz    = 64;
+  uve_vlen         = defaultRegisterLength;
+  uve_stats_file   = nullptr;
+  uve_bf16         = false;
+  uve_e5m2         = false;
 }
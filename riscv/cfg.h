@@ -59,6 +59,14 @@ private:
   reg_t size;
 };
 
+// Streaming Engine timing model of UVE, see streaming_timing.h
+struct uve_timing_cfg_t
+{
+  reg_t fifo_depth; // chunks buffered per stream
+  reg_t bandwidth;  // bytes per cycle of the memory port
+  reg_t latency;    // cycles
+};
+
 class cfg_t
 {
 public:
@@ -79,6 +87,11 @@ public:
   bool                    real_time_clint;
   reg_t                   trigger_count;
   reg_t                   cache_blocksz;
+  reg_t                   uve_vlen;
+  const char *            uve_stats_file;
+  std::optional<uve_timing_cfg_t> uve_timing;
+  bool                    uve_bf16;
+  bool                    uve_e5m2;
   std::optional<abstract_sim_if_t*> external_simulator;
 
   size_t nprocs() const { return hartids.size(); }
@@ -0,0 +1,243 @@
+#include "descriptors.h"
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+/* Differential test for descriptorIterator_t. Random stream descriptors are
+walked both by the iterator and by a reference walker that keeps dimensions
+and modifiers in plain containers and rescans them on every access, the way
+streams were walked before being lowered at ss.end. Both must produce the
+same address sequence and the same EOD flags after every register access. */
+
+struct referenceWalker_t {
+    std::vector<dimension_t> dimensions;
+    std::unordered_multimap<int, staticModifier_t> staticModifiers;
+    size_t baseAddress;
+    size_t elementWidth;
+    int vecCfgDim;
+
+    std::span<dimension_t> all() {
+        return std::span<dimension_t>(dimensions.data(), dimensions.size());
+    }
+
+    bool isDimensionFullyDone(size_t start) const {
+        for (size_t i = start; i < dimensions.size(); i++)
+            if (!dimensions[i].isEndOfDimension())
+                return false;
+        return true;
+    }
+
+    bool isStreamDone() const {
+        return dimensions.empty() || dimensions[0].isEndOfDimension();
+    }
+
+    size_t getDimensionCount() const {
+        return dimensions.size();
+    }
+
+    bool isEndOfDimension(size_t i) const {
+        return dimensions[i].isEndOfDimension();
+    }
+
+    /* Every element goes through the per-element path */
+    size_t contiguousRunLength(size_t, size_t &) {
+        return 0;
+    }
+
+    void skipIterations(size_t) {}
+    void setSGModsNotApplied() {}
+
+    void finish() {
+        for (auto &dim : dimensions)
+            dim.setEndOfDimension(true);
+    }
+
+    size_t generateAddress() {
+        size_t acc = baseAddress;
+        for (size_t n = 0; n < dimensions.size(); n++) {
+            dimension_t &dim = dimensions[dimensions.size() - 1 - n];
+            if (dim.isLastIteration() && isDimensionFullyDone(dimensions.size() - n))
+                dim.setEndOfDimension(true);
+            acc += dim.calcAddress(elementWidth);
+        }
+        return acc;
+    }
+
+    bool tryGenerateAddress(size_t &address) {
+        bool canGenerateAddress = true;
+        for (int i = int(dimensions.size() - 1); i >= 0; i--) {
+            if (dimensions[i].isEmpty()) {
+                for (size_t j = i; j < dimensions.size(); j++)
+                    dimensions[j].setEndOfDimension(true);
+                canGenerateAddress = false;
+            }
+            if (i == vecCfgDim && isDimensionFullyDone(i)) {
+                canGenerateAddress = false;
+                break;
+            }
+        }
+        address = generateAddress();
+        return canGenerateAddress;
+    }
+
+    void updateIteration() {
+        bool validIter = dimensions.back().advance();
+        for (int i = int(dimensions.size() - 1); i > 0; --i) {
+            if (!dimensions[i].isEndOfDimension())
+                continue;
+            if (validIter) {
+                auto range = staticModifiers.equal_range(i);
+                for (auto it = range.first; it != range.second; ++it)
+                    dimensions[it->second.getTargetDim()].resetIterValues();
+            }
+            dimensions[i].setEndOfDimension(false);
+            validIter = dimensions[i - 1].advance();
+            if (validIter) {
+                auto range = staticModifiers.equal_range(i - 1);
+                for (auto it = range.first; it != range.second; ++it)
+                    it->second.modDimension(all(), elementWidth);
+            }
+        }
+    }
+};
+
+struct trace_t {
+    std::vector<size_t> addresses;
+    std::vector<uint8_t> flags;
+};
+
+static const size_t width = 4;
+
+/* Mirrors the access loop of a load stream register holding max elements,
+including the end of stream checks the register does around the walker */
+template <typename Walker>
+static bool walk(Walker &w, size_t max, bool bulk, trace_t &t) {
+    auto tryGenerateAddress = [&](size_t &address) {
+        if (w.isStreamDone()) {
+            w.finish();
+            return false;
+        }
+        return w.tryGenerateAddress(address);
+    };
+    auto updateIteration = [&]() {
+        if (w.isStreamDone())
+            w.finish();
+        else
+            w.updateIteration();
+    };
+
+    if (w.isStreamDone()) {
+        w.finish();
+        return false;
+    }
+    size_t eCount = 0, address;
+    while (eCount < max) {
+        if (size_t run = bulk ? w.contiguousRunLength(max - eCount, address) : 0) {
+            for (size_t i = 0; i < run; i++)
+                t.addresses.push_back(address + i * width);
+            eCount += run;
+            w.skipIterations(run);
+        }
+        if (!tryGenerateAddress(address))
+            break;
+        t.addresses.push_back(address);
+        w.setSGModsNotApplied();
+        if (tryGenerateAddress(address) && ++eCount < max)
+            updateIteration();
+        else
+            break;
+    }
+    for (size_t i = 0; i < w.getDimensionCount(); i++)
+        t.flags.push_back(w.isEndOfDimension(i));
+    updateIteration();
+    return true;
+}
+
+int main()
+{
+    std::mt19937 rng(0x5eed);
+    auto pick = [&](int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+    bool ok = true;
+
+    /* The iterator is re-configured for every descriptor, as streams in a loop
+    are. Half of the descriptors repeat the shape of the previous one with new
+    dimension values, which keeps the modifiers lowered before */
+    descriptorIterator_t iter;
+    int dims = 0, vecCfgDim = -1;
+    std::vector<std::vector<staticModifier_t>> modifiers;
+
+    for (int test = 0; test < 5000 && ok; test++) {
+        referenceWalker_t ref;
+        const size_t base = 0x1000 * pick(1, 4);
+        const size_t max = pick(0, 3) ? 16 : 1;
+        const bool bulk = pick(0, 1);
+        const bool sameShape = test && pick(0, 1);
+
+        bool reused = sameShape;
+        if (!sameShape) {
+            const int previousDims = dims, previousVecCfgDim = vecCfgDim == -1 ? dims - 1 : vecCfgDim;
+            auto previousModifiers = std::move(modifiers);
+            dims = pick(1, 5);
+            vecCfgDim = pick(-1, dims - 1);
+            modifiers = std::vector<std::vector<staticModifier_t>>(dims);
+            for (int i = 0; i < dims; i++)
+                for (int m = pick(0, 3) ? 0 : pick(1, 3); m > 0; m--)
+                    modifiers[i].push_back(staticModifier_t(Target(pick(0, 2)), staticBehaviour(pick(0, 1)), pick(0, 3), pick(0, dims - 1)));
+
+            /* A new shape may happen to be the same as the previous one */
+            reused = test && dims == previousDims && (vecCfgDim == -1 ? dims - 1 : vecCfgDim) == previousVecCfgDim;
+            for (int i = 0; reused && i < dims; i++) {
+                reused = modifiers[i].size() == previousModifiers[i].size();
+                for (size_t m = 0; reused && m < modifiers[i].size(); m++)
+                    reused = modifiers[i][m].hasSameConfiguration(previousModifiers[i][m]);
+            }
+        }
+
+        ref.baseAddress = base;
+        ref.elementWidth = width;
+        iter.startConfiguration(base, width);
+        iter.configureVecDim(vecCfgDim);
+
+        for (int i = 0; i < dims; i++) {
+            dimension_t dim(width * pick(0, 8), pick(0, 4) ? pick(1, 9) : 0, pick(0, 3) ? pick(-2, 3) : 1);
+            ref.dimensions.push_back(dim);
+            iter.addDimension(dim);
+            for (auto &mod : modifiers[i]) {
+                ref.staticModifiers.insert({i, mod});
+                iter.addStaticModifier(mod);
+            }
+        }
+        ref.vecCfgDim = vecCfgDim == -1 ? dims - 1 : vecCfgDim;
+        iter.endConfiguration();
+
+        if (iter.isShapeReused() != reused) {
+            fprintf(stderr, "Descriptor %d %s the shape of the previous one\n", test, reused ? "does not reuse" : "wrongly reuses");
+            ok = false;
+        }
+
+        trace_t expected, actual;
+        for (int access = 0; access < 200; access++) {
+            bool r = walk(ref, max, false, expected);
+            bool a = walk(iter, max, bulk, actual);
+            if (r != a || !r)
+                break;
+            /* Registers holding the iterator get copied around, and the
+            copies must keep tracking their own EOD flags */
+            if (access % 7 == 3) {
+                descriptorIterator_t copy = iter;
+                iter = std::move(copy);
+            }
+        }
+
+        if (expected.addresses != actual.addresses || expected.flags != actual.flags) {
+            fprintf(stderr, "Descriptor %d (%d dimensions, vecCfgDim %d, %zu elements) diverges: "
+                    "%zu/%zu addresses, %zu/%zu flags\n", test, dims, vecCfgDim, max,
+                    expected.addresses.size(), actual.addresses.size(),
+                    expected.flags.size(), actual.flags.size());
+            ok = false;
+        }
+    }
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,195 @@
+#include "mmu.h"
+#include "processor.h"
+#include "simif.h"
+#include "trap.h"
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+/* Checks that stream accesses trapping on pages that are not mapped yet can
+be retried exactly. Every scenario runs a sequence of emulated instructions
+twice: with all memory in place, and with the pages of the streams missing
+until an access faults on them, in which case a "kernel" maps the page and the
+instruction is executed again. Register contents, EOD flags and memory must
+end up the same in both runs */
+
+struct pagedSim_t : simif_t {
+    static constexpr reg_t base = 0x80000000, size = 64 * PGSIZE;
+    std::vector<char> mem = std::vector<char>(size);
+    std::vector<bool> present = std::vector<bool>(size / PGSIZE, true);
+    cfg_t cfg;
+    std::map<size_t, processor_t *> harts;
+
+    char *addr_to_mem(reg_t addr) override {
+        if (addr < base || addr >= base + size || !present[(addr - base) / PGSIZE])
+            return nullptr;
+        return &mem[addr - base];
+    }
+    bool mmio_load(reg_t, size_t, uint8_t *) override { return false; }
+    bool mmio_store(reg_t, size_t, const uint8_t *) override { return false; }
+    void proc_reset(unsigned) override {}
+    const cfg_t &get_cfg() const override { return cfg; }
+    const std::map<size_t, processor_t *> &get_harts() const override { return harts; }
+    const char *get_symbol(uint64_t) override { return nullptr; }
+
+    void reset(bool mapped) {
+        for (size_t i = 0; i < size; i++)
+            mem[i] = char(i * 13 + 5);
+        /* Index streams read small word offsets */
+        for (size_t i = 0; i < 4 * PGSIZE; i += 4) {
+            const uint32_t index = (i / 4 * 7 + 3) % 200;
+            memcpy(&mem[48 * PGSIZE + i], &index, 4);
+        }
+        present.assign(present.size(), mapped);
+    }
+};
+
+static pagedSim_t sim;
+
+/* Calls f until it goes through, mapping the page of every fault it takes
+as a kernel would. Returns the number of faults served */
+static size_t retry(processor_t &p, const std::function<void()> &f) {
+    for (size_t faults = 0;; faults++) {
+        try {
+            f();
+            return faults;
+        } catch (trap_t &t) {
+            sim.present.at((t.get_tval() - pagedSim_t::base) / PGSIZE) = true;
+            p.get_mmu()->flush_tlb();
+        }
+    }
+}
+
+/* Runs count instructions, each a call of step. Returns the contents step
+records, and adds the number of faults served to faults */
+static std::vector<uint64_t> run(processor_t &p, size_t count, const std::function<void(std::vector<uint64_t> &)> &step, size_t &faults) {
+    std::vector<uint64_t> trace;
+    for (size_t i = 0; i < count; i++) {
+        const reg_t pc = 0x1000 + 4 * (i % 3);
+        std::vector<uint64_t> out;
+        faults += retry(p, [&] {
+            out.clear();
+            p.SU.beginInstruction(pc);
+            step(out);
+        });
+        trace.insert(trace.end(), out.begin(), out.end());
+    }
+    return trace;
+}
+
+template <typename T>
+static void record(std::vector<uint64_t> &out, streamingUnit_t &su, size_t reg) {
+    auto &r = std::get<streamRegister_t<T>>(su.registers[reg]);
+    out.push_back(r.getValidElements());
+    out.push_back(r.hasStreamFinished());
+    out.push_back(su.EODTable[reg]);
+    auto e = r.getElements(false);
+    for (size_t i = 0; i < r.getValidElements(); i++)
+        out.push_back(e[i]);
+}
+
+static uint64_t memoryHash() {
+    uint64_t h = 0;
+    for (char c : sim.mem)
+        h = h * 131 + (unsigned char)c;
+    return h;
+}
+
+/* Runs scenario, which configures the streams and returns the step of each
+instruction, with and without faults. Configurations fetching indices may
+fault too, and are then done again from the start */
+static bool check(const char *name, processor_t &p, size_t count, const std::function<std::function<void(std::vector<uint64_t> &)>()> &scenario) {
+    size_t faults = 0;
+    sim.reset(true);
+    const auto expected = run(p, count, scenario(), faults);
+    const uint64_t expectedMemory = memoryHash();
+
+    sim.reset(false);
+    p.get_mmu()->flush_tlb();
+    std::function<void(std::vector<uint64_t> &)> step;
+    faults = retry(p, [&] { step = scenario(); });
+    const auto actual = run(p, count, step, faults);
+
+    const bool ok = faults > 0 && actual == expected && memoryHash() == expectedMemory;
+    if (!ok)
+        fprintf(stderr, "%s: %zu faults, %s contents, %s memory\n", name, faults,
+                actual == expected ? "same" : "different", memoryHash() == expectedMemory ? "same" : "different");
+    return ok;
+}
+
+template <typename T>
+static streamRegister_t<T> &configure(streamingUnit_t &su, size_t reg, RegisterConfig type, size_t page, std::vector<dimension_t> dims,
+                                      const std::function<void(streamRegister_t<T> &, size_t)> &modifiers = {}) {
+    su.makeStreamRegister<T>(reg, type);
+    auto &r = std::get<streamRegister_t<T>>(su.registers[reg]);
+    r.startConfiguration(pagedSim_t::base + page * PGSIZE + 8);
+    for (size_t d = 0; d < dims.size(); d++) {
+        r.addDimension(dims[d]);
+        if (modifiers)
+            modifiers(r, d);
+    }
+    r.endConfiguration();
+    return r;
+}
+
+int main()
+{
+    processor_t p("rv64gc", "msu", &sim.cfg, &sim, 0, false, nullptr, std::cerr);
+    sim.harts[0] = &p;
+    streamingUnit_t &su = p.SU;
+    bool ok = true;
+
+    ok &= check("2-D load across pages", p, 200, [&] {
+        configure<uint32_t>(su, 1, RegisterConfig::Load, 2, {dimension_t(0, 9, 700), dimension_t(0, 150, 1)});
+        return [&](std::vector<uint64_t> &out) {
+            std::get<StreamReg32>(su.registers[1]).getElements();
+            record<uint32_t>(out, su, 1);
+        };
+    });
+
+    /* so.a.add-like: the second source or the destination trap after the
+    first source was filled */
+    ok &= check("two loads and a store", p, 120, [&] {
+        configure<uint64_t>(su, 1, RegisterConfig::Load, 10, {dimension_t(0, 600, 1)});
+        configure<uint64_t>(su, 2, RegisterConfig::Load, 20, {dimension_t(0, 40, 3), dimension_t(0, 15, 1)});
+        configure<uint64_t>(su, 3, RegisterConfig::Store, 30, {dimension_t(0, 300, 2)});
+        return [&](std::vector<uint64_t> &out) {
+            auto &dest = std::get<StreamReg64>(su.registers[3]);
+            if (dest.hasStreamFinished())
+                return;
+            auto a = std::get<StreamReg64>(su.registers[1]).getElements();
+            auto b = std::get<StreamReg64>(su.registers[2]).getElements();
+            typename StreamReg64::ElementsStorage sum{};
+            for (size_t i = 0; i < dest.getVLen(); i++)
+                sum[i] = a[i] + b[i];
+            dest.setMode(RegisterMode::Vector);
+            dest.setElements(std::span<const uint64_t>(sum.data(), dest.getVLen()));
+            record<uint64_t>(out, su, 1);
+            record<uint64_t>(out, su, 2);
+            out.push_back(su.EODTable[3]);
+        };
+    });
+
+    /* Index fetches trapping in the middle of the iteration update of the
+    streams they modify */
+    ok &= check("dynamic and scatter-gather modifiers", p, 150, [&] {
+        auto &indices = configure<uint32_t>(su, 5, RegisterConfig::IndSource, 48, {dimension_t(0, 2000, 1)});
+        indices.setMode(RegisterMode::Scalar);
+        configure<uint32_t>(su, 1, RegisterConfig::Load, 36, {dimension_t(0, 40, 50), dimension_t(0, 9, 1)}, [&](auto &r, size_t d) {
+            if (d == 0)
+                r.addDynamicModifier(dynamicModifier_t(Target::Offset, dynamicBehaviour::Add, 5, &su, 1));
+        });
+        configure<uint32_t>(su, 2, RegisterConfig::Load, 40, {dimension_t(0, 2000, 1)}, [&](auto &r, size_t) {
+            r.addScatterGModifier(scatterGModifier_t(dynamicBehaviour::Add, 5, &su));
+        });
+        return [&](std::vector<uint64_t> &out) {
+            std::get<StreamReg32>(su.registers[1]).getElements();
+            std::get<StreamReg32>(su.registers[2]).getElements();
+            record<uint32_t>(out, su, 1);
+            record<uint32_t>(out, su, 2);
+        };
+    });
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,105 @@
+#include "streaming_fp16.h"
+#include <cstdio>
+#include <random>
+
+/* Checks the 16-bit computation types, which compute in host single
+precision, against the 16-bit operations of softfloat. Every pair of random
+operands, subnormals and special values included, must give the same bits, or
+both a NaN */
+
+static std::mt19937_64 rng(0x5eed);
+
+struct halfReference_t {
+    using T = float16_t;
+    static T add(T a, T b) { return f16_add(a, b); }
+    static T sub(T a, T b) { return f16_sub(a, b); }
+    static T mul(T a, T b) { return f16_mul(a, b); }
+    static T div(T a, T b) { return f16_div(a, b); }
+    static T sqrt(T a) { return f16_sqrt(a); }
+    static bool eq(T a, T b) { return f16_eq(a, b); }
+    static bool lt(T a, T b) { return f16_lt(a, b); }
+    static bool le(T a, T b) { return f16_le(a, b); }
+    static T fromF32(float32_t a) { return f32_to_f16(a); }
+};
+
+struct bfloatReference_t {
+    using T = bfloat16_t;
+    static T add(T a, T b) { return bf16_add(a, b); }
+    static T sub(T a, T b) { return bf16_sub(a, b); }
+    static T mul(T a, T b) { return bf16_mul(a, b); }
+    static T div(T a, T b) { return bf16_div(a, b); }
+    static T sqrt(T a) { return bf16_sqrt(a); }
+    static bool eq(T a, T b) { return bf16_eq(a, b); }
+    static bool lt(T a, T b) { return bf16_lt(a, b); }
+    static bool le(T a, T b) { return bf16_le(a, b); }
+    static T fromF32(float32_t a) { return f32_to_bf16(a); }
+};
+
+template <typename Format>
+static bool isNaN(std::uint16_t bits) {
+    return (bits & Format::infinity) == Format::infinity && (bits & ~(Format::infinity | 0x8000)) != 0;
+}
+
+template <typename Format, typename Reference>
+static bool check(const char *format) {
+    using T = fp16_t<Format>;
+    using R = typename Reference::T;
+    static const std::uint16_t special[] = {0x0000, 0x8000, 0x0001, 0x8001, Format::minNormal, Format::maxFinite, Format::infinity,
+                                            std::uint16_t(Format::infinity | 0x8000), std::uint16_t(Format::infinity | 1)};
+    auto operand = [](int trial) {
+        return trial % 4 == 0 ? T::fromBits(special[rng() % std::size(special)]) : T::fromBits(std::uint16_t(rng()));
+    };
+
+    for (int trial = 0; trial < 200000; trial++) {
+        const T a = operand(trial), b = operand(trial >> 1);
+        const R x{a.bits}, y{b.bits};
+        const float tripled = float(a) * 3.0f;
+        const struct {
+            const char *name;
+            T actual;
+            std::uint16_t expected;
+        } results[] = {
+            {"add", a + b, Reference::add(x, y).v},
+            {"sub", a - b, Reference::sub(x, y).v},
+            {"mul", a * b, Reference::mul(x, y).v},
+            {"div", a / b, Reference::div(x, y).v},
+            {"sqrt", sqrt(a), Reference::sqrt(x).v},
+            {"abs", abs(a), std::uint16_t(a.bits & 0x7fff)},
+            {"conversion", T(double(a) * 3.0), Reference::fromF32(float32_t{readAS<std::uint32_t>(tripled)}).v},
+        };
+        for (const auto &r : results) {
+            const std::uint16_t expected = r.expected;
+            if (isNaN<Format>(r.actual.bits) ? !isNaN<Format>(expected) : r.actual.bits != expected) {
+                fprintf(stderr, "%s %s of %04x and %04x gives %04x instead of %04x\n", format, r.name, a.bits, b.bits, r.actual.bits, expected);
+                return false;
+            }
+        }
+        if ((a == b) != Reference::eq(x, y) || (a != b) == Reference::eq(x, y) || (a < b) != Reference::lt(x, y) ||
+            (a <= b) != Reference::le(x, y) || (a > b) != Reference::lt(y, x) || (a >= b) != Reference::le(y, x)) {
+            fprintf(stderr, "%s comparison of %04x and %04x differs\n", format, a.bits, b.bits);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+
+    /* The operations round to nearest even whatever the rounding mode of the
+    processor, and leave its exception flags alone */
+    softfloat_roundingMode = softfloat_round_max;
+    softfloat_exceptionFlags = softfloat_flag_inexact;
+    {
+        fp16Scope_t scope;
+        ok &= check<halfFormat_t, halfReference_t>("half");
+        ok &= check<bfloatFormat_t, bfloatReference_t>("bfloat16");
+    }
+    if (softfloat_roundingMode != softfloat_round_max || softfloat_exceptionFlags != softfloat_flag_inexact) {
+        fprintf(stderr, "rounding mode or exception flags not restored\n");
+        ok = false;
+    }
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,267 @@
+#include "streaming_kernels.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+/* Differential test for the element-wise and reduction kernels of the so.a.*
+instructions. Each operation is run through the kernels and through a copy of
+the per-lane loop the instructions used before, on random register lengths and contents, valid
+element counts, register and predicate modes. Destination contents and mode
+must match bit for bit. The predicate mask helpers are checked against plain
+per-flag loops */
+
+static std::mt19937_64 rng(0x5eed);
+
+template <typename Reg>
+static void randomise(Reg &reg, bool nonZero = false) {
+    std::array<typename Reg::ElementsType, Reg::maxVLen> e;
+    for (auto &x : e) {
+        x = rng();
+        if (nonZero)
+            x = (x >> 2) | 1;
+    }
+    reg.setElements(e);
+    reg.setMode(rng() % 4 ? RegisterMode::Vector : RegisterMode::Scalar);
+    reg.setValidIndex(rng() % (reg.getVLen() + 1));
+    reg.setPredMode(rng() % 2 ? PredicateMode::Zeroing : PredicateMode::Merging);
+}
+
+/* The loop of the instructions before the kernels, with the computation of
+a lane given by lane(out, i) */
+template <typename OperationType, typename Dest, typename Lane, typename... Srcs>
+static void legacyElementwise(Dest &dest, const predRegister_t &pred, TailPolicy tail, ResultMode mode, Lane lane, Srcs &...srcs) {
+    size_t vLen = ((srcs.getMode() == RegisterMode::Scalar) || ...) ? 1 : dest.getVLen();
+    bool zeroing = ((srcs.getPredMode() == PredicateMode::Zeroing) && ...);
+    auto elements = std::make_tuple(srcs.getElements()...);
+    auto out = dest.getElementsView();
+    auto validElementsIndex = std::min({srcs.getValidElements()...});
+
+    for (size_t i = 0; i < vLen; i++) {
+        if (i < validElementsIndex) {
+            if (pred.isElementActive(i, sizeof(OperationType)))
+                std::apply([&](auto &...e) { lane(out, i, e...); }, elements);
+        } else if (zeroing || tail == TailPolicy::AlwaysZero)
+            out[i] = 0;
+    }
+    dest.setMode(mode == ResultMode::Vector ? (dest.getVLen() == 1 ? RegisterMode::Scalar : RegisterMode::Vector)
+                                            : (vLen == 1 ? RegisterMode::Scalar : RegisterMode::Vector));
+    dest.setElements(out);
+}
+
+template <typename Reg>
+static bool same(Reg &a, Reg &b) {
+    return a.getElements(false) == b.getElements(false) && a.getMode() == b.getMode();
+}
+
+/* Runs kernel(dest, pred, srcs...) and legacy(dest, pred, srcs...) on copies of
+the same random registers */
+template <typename Reg, size_t Sources, typename Kernel, typename Legacy>
+static bool check(const char *name, Kernel kernel, Legacy legacy, bool nonZero = false) {
+    for (int trial = 0; trial < 2000; trial++) {
+        const size_t length = minRegisterLength << (rng() % 5);
+        Reg dest{nullptr, PredicateMode::Zeroing, RegisterConfig::NoStream, size_t(-1), length};
+        Reg src1 = dest, src2 = dest;
+        randomise(dest);
+        randomise(src1, nonZero && Sources == 1);
+        randomise(src2, nonZero);
+        predRegister_t::MaskType mask;
+        for (auto &w : mask.words)
+            w = rng();
+        predRegister_t pred(rng() % 4 ? mask : ~predRegister_t::MaskType(0));
+
+        Reg expected = dest, expectedSrc1 = src1, expectedSrc2 = src2;
+        if constexpr (Sources == 1) {
+            kernel(dest, pred, src1);
+            legacy(expected, pred, expectedSrc1);
+        } else {
+            kernel(dest, pred, src1, src2);
+            legacy(expected, pred, expectedSrc1, expectedSrc2);
+        }
+        if (!same(dest, expected)) {
+            fprintf(stderr, "%s (%zu-bit, %zu-byte registers) diverges on trial %d\n", name, Reg::elementWidth * 8, length, trial);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Reg, typename OperationType>
+static bool checkArithmetic(bool isFloat) {
+    using StorageType = typename Reg::ElementsType;
+    bool ok = true;
+
+    ok &= check<Reg, 2>("add", [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        auto op = [](OperationType e1, OperationType e2) { return OperationType(e1 + e2); };
+        streamElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, op, src1, src2);
+    }, [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        legacyElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, [](auto out, size_t i, auto &elements1, auto &elements2) {
+            OperationType e1 = readAS<OperationType>(elements1.at(i));
+            OperationType e2 = readAS<OperationType>(elements2.at(i));
+            out[i] = readAS<StorageType>(OperationType(e1 + e2));
+        }, src1, src2);
+    });
+
+    ok &= check<Reg, 2>("mac", [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        auto op = [](OperationType e1, OperationType e2, OperationType e3) { return OperationType(e1 * e2 + e3); };
+        streamElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, op, src1, src2);
+    }, [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        legacyElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, [](auto out, size_t i, auto &elements1, auto &elements2) {
+            OperationType e1 = readAS<OperationType>(elements1.at(i));
+            OperationType e2 = readAS<OperationType>(elements2.at(i));
+            OperationType e3 = readAS<OperationType>(out[i]);
+            out[i] = readAS<StorageType>(OperationType(e1 * e2 + e3));
+        }, src1, src2);
+    });
+
+    ok &= check<Reg, 2>("min", [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        auto op = [](OperationType e1, OperationType e2) { return std::min(e1, e2); };
+        streamElementwise<OperationType>(dest, pred, TailPolicy::AlwaysZero, ResultMode::Vector, op, src1, src2);
+    }, [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        legacyElementwise<OperationType>(dest, pred, TailPolicy::AlwaysZero, ResultMode::Vector, [](auto out, size_t i, auto &elements1, auto &elements2) {
+            out[i] = readAS<StorageType>(std::min(readAS<OperationType>(elements1.at(i)), readAS<OperationType>(elements2.at(i))));
+        }, src1, src2);
+    });
+
+    /* Divisors are kept non-zero, odd and positive so the reference does not trap */
+    ok &= check<Reg, 2>("div", [isFloat](auto &dest, auto &pred, auto &src1, auto &src2) {
+        auto op = [](OperationType e1, OperationType e2) { return OperationType(e1 / e2); };
+        if (isFloat)
+            streamElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, op, src1, src2);
+        else
+            streamElementwise<OperationType, LaneEvaluation::ActiveOnly>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, op, src1, src2);
+    }, [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        legacyElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, [](auto out, size_t i, auto &elements1, auto &elements2) {
+            OperationType e1 = readAS<OperationType>(elements1.at(i));
+            OperationType e2 = readAS<OperationType>(elements2.at(i));
+            out[i] = readAS<StorageType>(OperationType(e1 / e2));
+        }, src1, src2);
+    }, true);
+
+    ok &= check<Reg, 1>("dec", [](auto &dest, auto &pred, auto &src) {
+        auto op = [](OperationType e) { return OperationType(e - 1.0); };
+        streamElementwise<OperationType>(dest, pred, TailPolicy::AlwaysZero, ResultMode::FollowSources, op, src);
+    }, [](auto &dest, auto &pred, auto &src) {
+        legacyElementwise<OperationType>(dest, pred, TailPolicy::AlwaysZero, ResultMode::FollowSources, [](auto out, size_t i, auto &elements) {
+            OperationType e = readAS<OperationType>(elements.at(i)) - 1.0;
+            out[i] = readAS<StorageType>(e);
+        }, src);
+    });
+
+    ok &= check<Reg, 1>("adde", [](auto &dest, auto &pred, auto &src) {
+        auto elements = src.getElements();
+        auto out = dest.getElementsView();
+        OperationType value = reduceElements(elements, src.getValidElements(), pred, readAS<OperationType>(out[0]), [](OperationType acc, OperationType e) { return OperationType(acc + e); });
+        out[0] = readAS<StorageType>(value);
+        dest.setMode(RegisterMode::Scalar);
+        dest.setElements(out);
+    }, [](auto &dest, auto &pred, auto &src) {
+        auto elements = src.getElements();
+        auto out = dest.getElementsView();
+        OperationType value = readAS<OperationType>(out[0]);
+        for (size_t i = 0; i < src.getValidElements(); i++)
+            if (pred.isElementActive(i, sizeof(OperationType)))
+                value += readAS<OperationType>(elements.at(i));
+        out[0] = readAS<StorageType>(value);
+        dest.setMode(RegisterMode::Scalar);
+        dest.setElements(out);
+    });
+
+    return ok;
+}
+
+template <typename Reg, typename OperationType>
+static bool checkFloat() {
+    using StorageType = typename Reg::ElementsType;
+    bool ok = checkArithmetic<Reg, OperationType>(true);
+
+    ok &= check<Reg, 1>("sqrt", [](auto &dest, auto &pred, auto &src) {
+        auto op = [](OperationType e) { return e >= 0.0 ? sqrt(e) : decltype(sqrt(e))(0.0); };
+        streamElementwise<OperationType>(dest, pred, TailPolicy::AlwaysZero, ResultMode::FollowSources, op, src);
+    }, [](auto &dest, auto &pred, auto &src) {
+        legacyElementwise<OperationType>(dest, pred, TailPolicy::AlwaysZero, ResultMode::FollowSources, [](auto out, size_t i, auto &elements) {
+            OperationType e = readAS<OperationType>(elements.at(i));
+            if (e >= 0.0)
+                out[i] = readAS<StorageType>(OperationType(sqrt(e)));
+            else
+                out[i] = 0;
+        }, src);
+    });
+
+    return ok;
+}
+
+template <typename Reg, typename OperationType>
+static bool checkInteger() {
+    using StorageType = typename Reg::ElementsType;
+    bool ok = checkArithmetic<Reg, OperationType>(false);
+
+    ok &= check<Reg, 2>("sra", [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        const OperationType high_bit = static_cast<OperationType>(-1);
+        auto op = [high_bit](OperationType value, OperationType shift) { return (value >> (shift % 32)) | -((value & high_bit) >> (shift % 32)); };
+        streamElementwise<OperationType, LaneEvaluation::ActiveOnly>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, op, src1, src2);
+    }, [](auto &dest, auto &pred, auto &src1, auto &src2) {
+        legacyElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, [](auto out, size_t i, auto &values, auto &shiftValues) {
+            const OperationType high_bit = static_cast<OperationType>(-1);
+            auto value = readAS<OperationType>(values.at(i));
+            auto shift = readAS<OperationType>(shiftValues.at(i)) % 32;
+            out[i] = readAS<StorageType>(OperationType((value >> shift) | -((value & high_bit) >> shift)));
+        }, src1, src2);
+    });
+
+    ok &= check<Reg, 1>("not", [](auto &dest, auto &pred, auto &src) {
+        auto op = [](OperationType e) { return !e; };
+        streamElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, op, src);
+    }, [](auto &dest, auto &pred, auto &src) {
+        legacyElementwise<OperationType>(dest, pred, TailPolicy::ZeroIfZeroing, ResultMode::FollowSources, [](auto out, size_t i, auto &elements) {
+            OperationType e = readAS<OperationType>(elements.at(i));
+            out[i] = readAS<StorageType>(OperationType(!e));
+        }, src);
+    });
+
+    return ok;
+}
+
+static bool checkPredicates() {
+    using MaskType = predRegister_t::MaskType;
+    constexpr size_t flags = predRegister_t::maxVLen;
+    auto flag = [](const MaskType &m, size_t b) { return b < flags && m.test(b); };
+
+    for (int trial = 0; trial < 2000; trial++) {
+        MaskType m, p;
+        for (auto &w : m.words)
+            w = rng();
+        for (auto &w : p.words)
+            w = rng();
+        const size_t width = size_t(1) << (rng() % 4);
+        const size_t n = rng() % (flags + 1), s = rng() % (flags + 8);
+
+        const MaskType shl = m << s, shr = m >> s, rev = predRegister_t::reverse(m, n);
+        const MaskType first = predRegister_t::firstElements(n / width, width);
+        const MaskType merged = predRegister_t::merge(m, p, p ^ m, width);
+        for (size_t b = 0; b < flags; b++) {
+            const bool active = flag(p ^ m, (b / width + 1) * width - 1);
+            if (flag(shl, b) != (b >= s && flag(m, b - s)) || flag(shr, b) != flag(m, b + s) ||
+                flag(rev, b) != (b < n ? flag(m, n - 1 - b) : flag(m, b)) ||
+                flag(first, b) != (b < n / width * width) ||
+                flag(merged, b) != (active ? flag(m, b) : flag(p, b))) {
+                fprintf(stderr, "predicate helpers diverge on trial %d, flag %zu\n", trial, b);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = checkPredicates();
+    ok &= checkInteger<StreamReg8, std::int8_t>();
+    ok &= checkInteger<StreamReg16, std::uint16_t>();
+    ok &= checkInteger<StreamReg32, std::int32_t>();
+    ok &= checkInteger<StreamReg64, std::uint64_t>();
+    ok &= checkFloat<StreamReg32, float>();
+    ok &= checkFloat<StreamReg64, double>();
+    ok &= checkFloat<StreamReg16, half_t>();
+    ok &= checkFloat<StreamReg16, bfloat_t>();
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,262 @@
+#include "mmu.h"
+#include "processor.h"
+#include "simif.h"
+#include "trap.h"
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+/* Checks that the state saved by the streaming unit round-trips: a unit
+restoring it, be it the one that saved it or another one, goes on exactly as
+the one that saved it. Streams are saved mid-walk, mid-configuration and
+halfway through a fill that trapped */
+
+struct flatSim_t : simif_t {
+    static constexpr reg_t base = 0x80000000, size = 64 * PGSIZE;
+    std::vector<char> mem = std::vector<char>(size);
+    std::vector<bool> present = std::vector<bool>(size / PGSIZE, true);
+    cfg_t cfg;
+    std::map<size_t, processor_t *> harts;
+
+    char *addr_to_mem(reg_t addr) override {
+        if (addr < base || addr >= base + size || !present[(addr - base) / PGSIZE])
+            return nullptr;
+        return &mem[addr - base];
+    }
+    bool mmio_load(reg_t, size_t, uint8_t *) override { return false; }
+    bool mmio_store(reg_t, size_t, const uint8_t *) override { return false; }
+    void proc_reset(unsigned) override {}
+    const cfg_t &get_cfg() const override { return cfg; }
+    const std::map<size_t, processor_t *> &get_harts() const override { return harts; }
+    const char *get_symbol(uint64_t) override { return nullptr; }
+
+    void reset() {
+        for (size_t i = 0; i < size; i++)
+            mem[i] = char(i * 13 + 5);
+        for (size_t i = 0; i < 4 * PGSIZE; i += 4) {
+            const uint32_t index = (i / 4 * 7 + 3) % 200;
+            memcpy(&mem[48 * PGSIZE + i], &index, 4);
+        }
+        present.assign(present.size(), true);
+    }
+
+    uint64_t memoryHash() const {
+        uint64_t h = 0;
+        for (char c : mem)
+            h = h * 131 + (unsigned char)c;
+        return h;
+    }
+};
+
+static flatSim_t sim;
+
+static reg_t address(size_t page) {
+    return flatSim_t::base + page * PGSIZE + 8;
+}
+
+/* Streams of every kind: a 2-D load with a static modifier, a load with a
+dynamic modifier and one with a scatter-gather modifier fed by a scalar source
+of indices, and a store */
+static void configure(streamingUnit_t &su) {
+    su.makeStreamRegister<std::uint32_t>(5, RegisterConfig::IndSource);
+    auto &indices = std::get<StreamReg32>(su.registers[5]);
+    indices.startConfiguration(address(48));
+    indices.addDimension(dimension_t(0, 2000, 1));
+    indices.endConfiguration();
+    indices.setMode(RegisterMode::Scalar);
+
+    su.makeStreamRegister<std::uint16_t>(1, RegisterConfig::Load);
+    auto &triangle = std::get<StreamReg16>(su.registers[1]);
+    triangle.startConfiguration(address(2));
+    triangle.addDimension(dimension_t(0, 30, 90));
+    triangle.addStaticModifier(staticModifier_t(Target::Size, staticBehaviour::Increment, 3, 1));
+    triangle.addDimension(dimension_t(0, 1, 1));
+    triangle.endConfiguration();
+
+    su.makeStreamRegister<std::uint32_t>(2, RegisterConfig::Load);
+    auto &dynamic = std::get<StreamReg32>(su.registers[2]);
+    dynamic.startConfiguration(address(10));
+    dynamic.addDimension(dimension_t(0, 40, 50));
+    dynamic.addDynamicModifier(dynamicModifier_t(Target::Offset, dynamicBehaviour::Add, 5, &su, 1));
+    dynamic.addDimension(dimension_t(0, 9, 1));
+    dynamic.endConfiguration();
+
+    su.makeStreamRegister<std::uint32_t>(3, RegisterConfig::Load);
+    auto &gather = std::get<StreamReg32>(su.registers[3]);
+    gather.startConfiguration(address(20));
+    gather.addDimension(dimension_t(0, 2000, 1));
+    gather.addScatterGModifier(scatterGModifier_t(dynamicBehaviour::Add, 5, &su));
+    gather.endConfiguration();
+
+    su.makeStreamRegister<std::uint64_t>(4, RegisterConfig::Store);
+    auto &store = std::get<StreamReg64>(su.registers[4]);
+    store.startConfiguration(address(30));
+    store.addDimension(dimension_t(0, 20, 40));
+    store.addDimension(dimension_t(0, 17, 1));
+    store.endConfiguration();
+    store.setMode(RegisterMode::Vector);
+
+    su.makePredRegister(predRegister_t::MaskType(0xf0f0f0f0f0f0f0f0), 3);
+}
+
+template <typename T>
+static void record(std::vector<uint64_t> &out, streamingUnit_t &su, size_t reg, bool causesUpdate = true) {
+    auto &r = std::get<streamRegister_t<T>>(su.registers[reg]);
+    auto e = r.getElements(causesUpdate);
+    out.push_back(r.getValidElements());
+    out.push_back(r.hasStreamFinished());
+    out.push_back(su.EODTable[reg]);
+    for (size_t i = 0; i < r.getValidElements(); i++)
+        out.push_back(e[i]);
+}
+
+/* Walks the streams of configure for n instructions */
+static std::vector<uint64_t> walk(streamingUnit_t &su, size_t n) {
+    std::vector<uint64_t> out;
+    for (size_t i = 0; i < n; i++) {
+        su.beginInstruction(0x1000 + 4 * i);
+        record<std::uint16_t>(out, su, 1);
+        record<std::uint32_t>(out, su, 2);
+        record<std::uint32_t>(out, su, 3);
+        auto &store = std::get<StreamReg64>(su.registers[4]);
+        if (!store.hasStreamFinished()) {
+            typename StreamReg64::ElementsStorage values{};
+            for (size_t j = 0; j < store.getVLen(); j++)
+                values[j] = i * 100 + j;
+            store.setElements(std::span<const uint64_t>(values.data(), store.getVLen()));
+        }
+        out.push_back(su.EODTable[4]);
+        out.push_back(su.predicates[3].getPredicate().words[0]);
+    }
+    return out;
+}
+
+static bool expect(const char *what, bool condition) {
+    if (!condition)
+        fprintf(stderr, "%s\n", what);
+    return condition;
+}
+
+int main()
+{
+    processor_t a("rv64gc", "msu", &sim.cfg, &sim, 0, false, nullptr, std::cerr);
+    processor_t b("rv64gc", "msu", &sim.cfg, &sim, 1, false, nullptr, std::cerr);
+    sim.harts[0] = &a;
+    sim.harts[1] = &b;
+    bool ok = true;
+
+    /* An idle unit only saves the header, and restores from it */
+    std::vector<uint8_t> idle;
+    a.SU.saveState(idle);
+    ok &= expect("idle unit saved more than its header", idle.size() == 18);
+    ok &= expect("idle state not restored", b.SU.restoreState(idle) == idle.size());
+
+    /* Streams saved mid-walk go on the same in the unit restoring them, and
+    in another unit */
+    sim.reset();
+    configure(a.SU);
+    walk(a.SU, 7);
+    std::vector<uint8_t> saved;
+    a.SU.saveState(saved);
+    const std::vector<char> memory = sim.mem;
+    const auto expected = walk(a.SU, 60);
+    const uint64_t expectedMemory = sim.memoryHash();
+
+    for (processor_t *p : {&a, &b}) {
+        if (p == &a)
+            walk(a.SU, 3);
+        sim.mem = memory;
+        ok &= expect("saved state not restored", p->SU.restoreState(saved) == saved.size());
+        std::vector<uint8_t> again;
+        p->SU.saveState(again);
+        ok &= expect("restored state saved differently", again == saved);
+        ok &= expect(p == &a ? "walk differs after restoring" : "walk differs in another unit", walk(p->SU, 60) == expected);
+        ok &= expect("stored memory differs", sim.memoryHash() == expectedMemory);
+    }
+
+    /* A configuration in progress is finished in the unit restoring it. The
+    descriptor reused from the previous configuration keeps its modifiers */
+    {
+        auto &dynamic = std::get<StreamReg32>(a.SU.registers[2]);
+        dynamic.startConfiguration(address(12));
+        dynamic.addDimension(dimension_t(0, 30, 60));
+        std::vector<uint8_t> partial;
+        a.SU.saveState(partial);
+        ok &= expect("partial configuration not restored", b.SU.restoreState(partial) == partial.size());
+
+        std::vector<uint64_t> runs[2];
+        for (processor_t *p : {&a, &b}) {
+            auto &r = std::get<StreamReg32>(p->SU.registers[2]);
+            r.addDynamicModifier(dynamicModifier_t(Target::Offset, dynamicBehaviour::Add, 5, &p->SU, 1));
+            r.addDimension(dimension_t(0, 9, 1));
+            const std::uint64_t hits = p->SU.configurationHits;
+            r.endConfiguration();
+            ok &= expect("shape not reused after restoring", p->SU.configurationHits == hits + 1);
+            for (size_t i = 0; i < 30; i++)
+                record<std::uint32_t>(runs[p == &b], p->SU, 2);
+        }
+        ok &= expect("configuration finished differently", runs[0] == runs[1]);
+    }
+
+    /* A fill trapping halfway is saved on the trap, as a context switch
+    would, and the instruction retried in another unit */
+    {
+        auto fill = [](streamingUnit_t &su) {
+            su.makeStreamRegister<std::uint64_t>(6, RegisterConfig::Load);
+            auto &r = std::get<StreamReg64>(su.registers[6]);
+            r.startConfiguration(address(40) + PGSIZE - 24);
+            r.configureVecDim();
+            r.addDimension(dimension_t(0, 100, 1));
+            r.endConfiguration();
+        };
+        sim.reset();
+        fill(a.SU);
+        std::vector<uint64_t> expectedFill, actualFill;
+        a.SU.beginInstruction(0x2000);
+        record<std::uint64_t>(expectedFill, a.SU, 6);
+
+        sim.reset();
+        fill(a.SU);
+        sim.present[41] = false;
+        a.get_mmu()->flush_tlb();
+        b.get_mmu()->flush_tlb();
+        std::vector<uint8_t> trapped;
+        a.SU.beginInstruction(0x2000);
+        try {
+            a.SU.operateRegister(6, [](auto &r) { r.getElements(); });
+            ok &= expect("fill did not trap", false);
+        } catch (trap_t &) {
+            a.SU.saveState(trapped);
+        }
+        sim.present[41] = true;
+        ok &= expect("trapped fill not restored", b.SU.restoreState(trapped) == trapped.size());
+        b.SU.beginInstruction(0x2000);
+        record<std::uint64_t>(actualFill, b.SU, 6);
+        ok &= expect("retried fill differs", actualFill == expectedFill);
+    }
+
+    /* State of another version, register length, or cut short is rejected,
+    leaving the unit reset */
+    {
+        std::vector<uint8_t> other = saved;
+        other[4]++;
+        ok &= expect("other version restored", b.SU.restoreState(other) == 0);
+        std::vector<uint8_t> state;
+        b.SU.saveState(state);
+        ok &= expect("unit not reset after a rejected state", state == idle);
+
+        other = saved;
+        other[6] = uint8_t(a.SU.getRegisterLength() * 2);
+        ok &= expect("other register length restored", b.SU.restoreState(other) == 0);
+        ok &= expect("cut state restored", b.SU.restoreState(std::span<const uint8_t>(saved.data(), saved.size() - 1)) == 0);
+    }
+
+    /* Resetting the processor resets the unit */
+    a.reset();
+    std::vector<uint8_t> state;
+    a.SU.saveState(state);
+    ok &= expect("processor reset left streams behind", state == idle);
+
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,72 @@
+#include "streaming_timing.h"
+#include <cstdio>
+
+/* Checks the stall estimates of the Streaming Engine timing model on streams
+whose cost is bound by latency, by bandwidth, or fully hidden by the FIFO */
+
+static bool expect(const char *what, std::uint64_t actual, std::uint64_t expected) {
+    if (actual != expected)
+        fprintf(stderr, "%s: %llu stall cycles, expected %llu\n", what, (unsigned long long)actual, (unsigned long long)expected);
+    return actual == expected;
+}
+
+int main()
+{
+    bool ok = true;
+
+    {
+        /* A single 64-byte chunk in flight at a time: every access waits for
+        the transfer (1 cycle) and the latency of the one requested by the
+        previous access */
+        streamTiming_t timing(1, 1, 64, 100);
+        timing.configure(0);
+        ok &= expect("latency bound, first access", timing.load(0, 64), 101);
+        timing.retire();
+        ok &= expect("latency bound, next access", timing.load(0, 64), 100);
+        ok &= expect("latency bound, pending", timing.takeStallCycles(), 201);
+        ok &= expect("latency bound, taken", timing.takeStallCycles(), 0);
+    }
+
+    {
+        /* A deep FIFO and a consumer slower than the port hide the latency
+        after the first access */
+        streamTiming_t timing(1, 8, 64, 20);
+        timing.configure(0);
+        std::uint64_t stalls = timing.load(0, 64);
+        for (int i = 0; i < 100; i++) {
+            for (int j = 0; j < 10; j++)
+                timing.retire();
+            stalls += timing.load(0, 64);
+        }
+        ok &= expect("latency hidden", stalls, 21);
+    }
+
+    {
+        /* Two streams sharing a port of 16 bytes per cycle and consumed back
+        to back are bound by bandwidth once the chunks fetched ahead are used:
+        8 cycles per access pair, one of them spent retiring */
+        streamTiming_t timing(2, 4, 16, 0);
+        timing.configure(0);
+        timing.configure(1);
+        std::uint64_t stalls = 0;
+        for (int i = 0; i < 60; i++) {
+            if (i == 10)
+                stalls = 0;
+            timing.retire();
+            stalls += timing.load(0, 64);
+            stalls += timing.load(1, 64);
+        }
+        ok &= expect("bandwidth bound", stalls, 50 * 7);
+    }
+
+    {
+        /* Stores only stall once the FIFO is full of chunks not yet written */
+        streamTiming_t timing(1, 2, 8, 0);
+        timing.configure(0);
+        ok &= expect("store, first chunk", timing.store(0, 64), 0);
+        ok &= expect("store, second chunk", timing.store(0, 64), 0);
+        ok &= expect("store, full FIFO", timing.store(0, 64), 8);
+    }
+
+    return ok ? 0 : -1;
+}
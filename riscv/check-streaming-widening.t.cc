@@ -0,0 +1,213 @@
+#include "streaming_kernels.h"
+#include <bit>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+/* Checks the widening kernels of so.a.mac.w.* and so.a.adde.acc.w.* against
+per-element loops, on random register lengths and contents, valid element
+counts, register and predicate modes. Integer results must match bit for bit.
+Floating-point ones are checked on small integers, which every format holds
+and every way of summing them gives exactly, in each element format */
+
+static std::mt19937_64 rng(0x5eed);
+
+template <typename Reg>
+static void randomise(Reg &reg, const std::function<typename Reg::ElementsType()> &value) {
+    std::array<typename Reg::ElementsType, Reg::maxVLen> e;
+    for (auto &x : e)
+        x = value();
+    reg.setElements(e);
+    reg.setMode(rng() % 4 ? RegisterMode::Vector : RegisterMode::Scalar);
+    reg.setValidIndex(rng() % (reg.getVLen() + 1));
+    reg.setPredMode(rng() % 2 ? PredicateMode::Zeroing : PredicateMode::Merging);
+}
+
+static predRegister_t randomPredicate() {
+    predRegister_t::MaskType mask;
+    for (auto &w : mask.words)
+        w = rng();
+    return predRegister_t(rng() % 4 ? mask : ~predRegister_t::MaskType(0));
+}
+
+/* Integer widening MAC and reduction, with Narrow and Wide the source and
+destination computation types */
+template <typename NarrowReg, typename WideReg, typename Narrow, typename Wide>
+static bool checkInteger(const char *name) {
+    using NarrowStorage = typename NarrowReg::ElementsType;
+    using WideStorage = typename WideReg::ElementsType;
+    constexpr size_t ratio = sizeof(Wide) / sizeof(Narrow);
+
+    for (int trial = 0; trial < 2000; trial++) {
+        const size_t length = minRegisterLength << (rng() % 5);
+        NarrowReg src1{nullptr, PredicateMode::Zeroing, RegisterConfig::NoStream, size_t(-1), length};
+        NarrowReg src2 = src1;
+        WideReg dest{nullptr, PredicateMode::Zeroing, RegisterConfig::NoStream, size_t(-1), length};
+        randomise(src1, [] { return NarrowStorage(rng()); });
+        randomise(src2, [] { return NarrowStorage(rng()); });
+        randomise(dest, [] { return WideStorage(rng()); });
+        const predRegister_t pred = randomPredicate();
+
+        /* Per-element reference */
+        const size_t vLen = src1.getMode() == RegisterMode::Scalar || src2.getMode() == RegisterMode::Scalar ? 1 : src1.getVLen();
+        const size_t valid = std::min({vLen, src1.getValidElements(), src2.getValidElements()});
+        const bool zeroing = src1.getPredMode() == PredicateMode::Zeroing && src2.getPredMode() == PredicateMode::Zeroing;
+        auto a = src1.getElements(false), b = src2.getElements(false);
+        auto expected = dest.getElements(false);
+        auto expectedSum = expected[0];
+        std::array<bool, WideReg::maxVLen> written{};
+        for (size_t i = 0; i < valid; i++) {
+            if (!pred.isElementActive(i, sizeof(Narrow)))
+                continue;
+            expected[i / ratio] = WideStorage(Wide(expected[i / ratio]) + Wide(Narrow(a[i])) * Wide(Narrow(b[i])));
+            expectedSum = WideStorage(Wide(expectedSum) + Wide(Narrow(a[i])));
+            written[i / ratio] = true;
+        }
+        for (size_t j = 0; j * ratio < vLen; j++)
+            if (!written[j] && zeroing && j * ratio >= valid)
+                expected[j] = 0;
+
+        WideReg sum = dest;
+        streamWidening(dest, pred, [](WideStorage acc, size_t n, const auto &x, const auto &y) {
+            Wide value = readAS<Wide>(acc);
+            for (size_t k = 0; k < n; k++)
+                value += Wide(readAS<Narrow>(x[k])) * Wide(readAS<Narrow>(y[k]));
+            return readAS<WideStorage>(value);
+        }, src1, src2);
+        const WideStorage actualSum = reduceWidening(a, src1.getValidElements(), pred, sum.getElements(false)[0], [](WideStorage acc, size_t n, const auto &e) {
+            Wide value = readAS<Wide>(acc);
+            for (size_t k = 0; k < n; k++)
+                value += Wide(readAS<Narrow>(e[k]));
+            return readAS<WideStorage>(value);
+        });
+
+        const RegisterMode mode = vLen == 1 ? RegisterMode::Scalar : RegisterMode::Vector;
+        /* The reduction reference covers the valid elements of both sources */
+        const bool sumComparable = src1.getValidElements() == valid;
+        if (dest.getElements(false) != expected || dest.getMode() != mode || (sumComparable && actualSum != expectedSum)) {
+            fprintf(stderr, "%s (%zu-byte registers) diverges on trial %d\n", name, length, trial);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Encodings of small integers in each floating-point element format */
+static std::uint8_t e4m3(int v) {
+    const std::uint8_t sign = v < 0 ? 0x80 : 0;
+    const int m = std::abs(v);
+    if (m == 0)
+        return sign;
+    const int e = std::bit_width(unsigned(m)) - 1;
+    return sign | ((e + 7) << 3) | ((m << 3 >> e) & 7);
+}
+
+static std::uint8_t e5m2(int v) {
+    const std::uint8_t sign = v < 0 ? 0x80 : 0;
+    const int m = std::abs(v);
+    if (m == 0)
+        return sign;
+    const int e = std::bit_width(unsigned(m)) - 1;
+    return sign | ((e + 15) << 2) | ((m << 2 >> e) & 3);
+}
+
+/* Floating-point widening MAC and reduction of random small integers, held
+with to(v) in the narrow format, against integer arithmetic. values are
+the integers the format holds exactly */
+template <typename NarrowReg, typename WideReg, typename Wide, typename Dot, typename Sum>
+static bool checkFloat(const char *name, const std::vector<int> &values, std::function<typename NarrowReg::ElementsType(int)> to, Dot dot, Sum sum) {
+    constexpr size_t ratio = sizeof(Wide) / NarrowReg::elementWidth;
+    using WideStorage = typename WideReg::ElementsType;
+
+    for (int trial = 0; trial < 500; trial++) {
+        const size_t length = minRegisterLength << (rng() % 5);
+        NarrowReg src1{nullptr, PredicateMode::Zeroing, RegisterConfig::NoStream, size_t(-1), length};
+        NarrowReg src2 = src1;
+        WideReg dest{nullptr, PredicateMode::Zeroing, RegisterConfig::NoStream, size_t(-1), length};
+        std::array<int, NarrowReg::maxVLen> x, y;
+        size_t k = 0;
+        randomise(src1, [&] { return to(x[k++] = values[rng() % values.size()]); });
+        k = 0;
+        randomise(src2, [&] { return to(y[k++] = values[rng() % values.size()]); });
+        src2.setMode(src1.getMode());
+        src2.setValidIndex(src1.getValidElements());
+        std::array<int, WideReg::maxVLen> z;
+        k = 0;
+        randomise(dest, [&] { return readAS<WideStorage>(Wide(z[k++] = int(rng() % 64) - 32)); });
+        const predRegister_t pred = randomPredicate();
+
+        const size_t vLen = src1.getMode() == RegisterMode::Scalar ? 1 : src1.getVLen();
+        const size_t valid = std::min(vLen, src1.getValidElements());
+        int expectedSum = z[0];
+        for (size_t i = 0; i < valid; i++) {
+            if (!pred.isElementActive(i, NarrowReg::elementWidth))
+                continue;
+            z[i / ratio] += x[i] * y[i];
+            expectedSum += x[i];
+        }
+
+        WideReg sumReg = dest;
+        const auto elements = src1.getElements(false);
+        const WideStorage actualSum = reduceWidening(elements, valid, pred, sumReg.getElements(false)[0], sum);
+        streamWidening(dest, pred, dot, src1, src2);
+        const auto out = dest.getElements(false);
+        bool ok = readAS<Wide>(actualSum) == Wide(expectedSum);
+        for (size_t j = 0; j * ratio < valid; j++)
+            ok &= readAS<Wide>(out[j]) == Wide(z[j]);
+        if (!ok) {
+            fprintf(stderr, "%s (%zu-byte registers) diverges on trial %d\n", name, length, trial);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    ok &= checkInteger<StreamReg8, StreamReg16, std::uint8_t, std::uint16_t>("us 8-bit");
+    ok &= checkInteger<StreamReg16, StreamReg32, std::uint16_t, std::uint32_t>("us 16-bit");
+    ok &= checkInteger<StreamReg32, StreamReg64, std::uint32_t, std::uint64_t>("us 32-bit");
+    ok &= checkInteger<StreamReg8, StreamReg16, std::int8_t, std::int16_t>("sg 8-bit");
+    ok &= checkInteger<StreamReg16, StreamReg32, std::int16_t, std::int32_t>("sg 16-bit");
+    ok &= checkInteger<StreamReg32, StreamReg64, std::int32_t, std::int64_t>("sg 32-bit");
+
+    streamingUnit_t su;
+    const std::vector<int> small = {-8, -6, -5, -4, -3, -2, -1, 0, 1, 2, 3, 4, 5, 6, 7, 8};
+    auto bulkDot = [&](std::uint32_t acc, size_t n, const auto &a, const auto &b) { return bulkDotAccumulate(su, acc, n, a, b); };
+    auto bulkSum = [&](std::uint32_t acc, size_t n, const auto &a) { return bulkSumAccumulate(su, acc, n, a); };
+    auto floatDot = [](std::uint32_t acc, size_t n, const auto &a, const auto &b) {
+        float value = readAS<float>(acc);
+        for (size_t k = 0; k < n; k++)
+            value += float(half_t::fromBits(a[k])) * float(half_t::fromBits(b[k]));
+        return readAS<std::uint32_t>(value);
+    };
+    auto floatSum = [](std::uint32_t acc, size_t n, const auto &a) {
+        float value = readAS<float>(acc);
+        for (size_t k = 0; k < n; k++)
+            value += float(half_t::fromBits(a[k]));
+        return readAS<std::uint32_t>(value);
+    };
+    auto doubleDot = [](std::uint64_t acc, size_t n, const auto &a, const auto &b) {
+        double value = readAS<double>(acc);
+        for (size_t k = 0; k < n; k++)
+            value += double(readAS<float>(a[k])) * double(readAS<float>(b[k]));
+        return readAS<std::uint64_t>(value);
+    };
+    auto doubleSum = [](std::uint64_t acc, size_t n, const auto &a) {
+        double value = readAS<double>(acc);
+        for (size_t k = 0; k < n; k++)
+            value += double(readAS<float>(a[k]));
+        return readAS<std::uint64_t>(value);
+    };
+
+    su.setFp8Format(Fp8Format::E4M3);
+    ok &= checkFloat<StreamReg8, StreamReg32, float>("fp e4m3", small, e4m3, bulkDot, bulkSum);
+    su.setFp8Format(Fp8Format::E5M2);
+    ok &= checkFloat<StreamReg8, StreamReg32, float>("fp e5m2", small, e5m2, bulkDot, bulkSum);
+    ok &= checkFloat<StreamReg16, StreamReg32, float>("fp bfloat16", small, [](int v) { return bfloat_t(v).bits; }, bulkDot, bulkSum);
+    ok &= checkFloat<StreamReg16, StreamReg32, float>("fp half", small, [](int v) { return half_t(v).bits; }, floatDot, floatSum);
+    ok &= checkFloat<StreamReg32, StreamReg64, double>("fp single", small, [](int v) { return readAS<std::uint32_t>(float(v)); }, doubleDot, doubleSum);
+
+    return ok ? 0 : -1;
+}
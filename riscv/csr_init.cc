@@ -88,7 +88,7 @@ void state_t::csr_init(processor_t* const proc, reg_t max_isa)
     const reg_t which_counter = CSR_HPMCOUNTER3 + i;
     const reg_t which_counterh = CSR_HPMCOUNTER3H + i;
     mevent[i] = std::make_shared<mevent_csr_t>(proc, which_mevent);
-    auto mcounter = std::make_shared<const_csr_t>(proc, which_mcounter, 0);
+    auto mcounter = std::make_shared<uve_counter_csr_t>(proc, which_mcounter, mevent[i]);
     add_csr(which_mcounter, mcounter);
 
     auto counter = std::make_shared<counter_proxy_csr_t>(proc, which_counter, mcounter);
@@ -96,7 +96,7 @@ void state_t::csr_init(processor_t* const proc, reg_t max_isa)
 
     if (xlen == 32) {
       add_csr(which_mevent, std::make_shared<rv32_low_csr_t>(proc, which_mevent, mevent[i]));
-      auto mcounterh = std::make_shared<const_csr_t>(proc, which_mcounterh, 0);
+      auto mcounterh = std::make_shared<rv32_high_csr_t>(proc, which_mcounterh, mcounter);
       add_csr(which_mcounterh, mcounterh);
       add_const_ext_csr(EXT_ZIHPM, which_counterh, std::make_shared<counter_proxy_csr_t>(proc, which_counterh, mcounterh));
       add_const_ext_csr(EXT_SSCOFPMF, which_meventh, std::make_shared<rv32_high_csr_t>(proc, which_meventh, mevent[i]));
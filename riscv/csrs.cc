@@ -1289,12 +1289,30 @@ mevent_csr_t::mevent_csr_t(processor_t* const proc, const reg_t addr):
   basic_csr_t(proc, addr, 0) {
 }
 
+// Event selector field of mhpmevent, bits 55:0
+static const reg_t MHPMEVENT_EVENT = (reg_t(1) << 56) - 1;
+
 bool mevent_csr_t::unlogged_write(const reg_t val) noexcept {
   const reg_t mask = proc->extension_enabled(EXT_SSCOFPMF) ? MHPMEVENT_OF | MHPMEVENT_MINH
     | (proc->extension_enabled_const('U') ? MHPMEVENT_UINH : 0)
     | (proc->extension_enabled_const('S') ? MHPMEVENT_SINH : 0)
     | (proc->extension_enabled('H') ? MHPMEVENT_VUINH | MHPMEVENT_VSINH : 0) : 0;
-  return basic_csr_t::unlogged_write((read() & ~mask) | (val & mask));
+  // Only the UVE events are implemented, other selectors read back as 0
+  const reg_t event = (val & MHPMEVENT_EVENT) < reg_t(uveEvent::Count) ? val & MHPMEVENT_EVENT : 0;
+  return basic_csr_t::unlogged_write((read() & ~(mask | MHPMEVENT_EVENT)) | (val & mask) | event);
+}
+
+uve_counter_csr_t::uve_counter_csr_t(processor_t* const proc, const reg_t addr, csr_t_p event):
+  csr_t(proc, addr),
+  event(event) {
+}
+
+reg_t uve_counter_csr_t::read() const noexcept {
+  return proc->SU.readEvent(event->read() & MHPMEVENT_EVENT);
+}
+
+bool uve_counter_csr_t::unlogged_write(const reg_t UNUSED val) noexcept {
+  return false;
 }
 
 hypervisor_csr_t::hypervisor_csr_t(processor_t* const proc, const reg_t addr):
@@ -633,6 +633,18 @@ class mevent_csr_t: public basic_csr_t {
   virtual bool unlogged_write(const reg_t val) noexcept override;
 };
 
+// mhpmcounter counting the UVE streaming unit event selected in its
+// mhpmevent. Writes are ignored.
+class uve_counter_csr_t: public csr_t {
+ public:
+  uve_counter_csr_t(processor_t* const proc, const reg_t addr, csr_t_p event);
+  virtual reg_t read() const noexcept override;
+ protected:
+  virtual bool unlogged_write(const reg_t val) noexcept override;
+ private:
+  csr_t_p event;
+};
+
 // For machine-level CSRs that only exist with Hypervisor
 class hypervisor_csr_t: public basic_csr_t {
  public:
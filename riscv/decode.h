@@ -156,7 +156,6 @@ public:
   uint64_t p_imm5() { return x(20, 5); }
   uint64_t p_imm6() { return x(20, 6); }
 
-<<<<<<< HEAD
   /*=== UVE ===*/
   uint64_t uve_rd() { return x(7, 5); }
   int64_t uve_rs1() { return x(15, 5); }
@@ -183,9 +182,8 @@ public:
   int64_t uve_pred_rs1() { return x(15, 4); } // Source: predicate register
   int64_t uve_pred_vs1() { return x(15, 5); } // Source: vector register
   int64_t uve_pred_rs2() { return x(20, 5); }
-=======
+
   uint64_t b_imm5() { return (x(20, 5) == 0) ? -1ul : x(20, 5); }
->>>>>>> master
 
   uint64_t zcmp_regmask() {
     unsigned mask = 0;
@@ -1,7 +1,10 @@
 #include "descriptors.h"
+#include "streaming_state.h"
 #include "streaming_unit.h"
+#include <algorithm>
 #include <iostream>
 #include <limits.h>
+#include <utility>
 
 /* Start of dimension_t function definitions */
 
@@ -9,7 +12,7 @@ void dimension_t::resetIterValues() {
     iter_offset = offset;
     iter_size = size;
     iter_stride = stride;
-    endOfDimension = iter_size == 0;
+    storeEndOfDimension(iter_size == 0);
 
     // std::cout << "RESET >>> iter_size: " << iter_size << std::endl;
 }
@@ -42,11 +45,23 @@ bool dimension_t::isEndOfDimension() const {
 
 void dimension_t::setEndOfDimension(bool b) {
     // std::cout << "Setting end of dimension to: " << b << std::endl;
-    endOfDimension = b;
+    storeEndOfDimension(b);
     if (!b)
         iter_index = 0;
 }
 
+void dimension_t::bindEndOfDimensionFlag(uint8_t *mask, size_t bit) {
+    eodMask = mask;
+    eodBit = bit;
+    storeEndOfDimension(endOfDimension);
+}
+
+void dimension_t::storeEndOfDimension(bool b) {
+    endOfDimension = b;
+    if (eodMask)
+        *eodMask = (*eodMask & ~(1u << eodBit)) | (unsigned(b) << eodBit);
+}
+
 size_t dimension_t::calcAddress(size_t width) const {
     //std::cout << "...Calculating address: siz: " << iter_size  << ", idx: " << iter_index << std::endl;
     return iter_offset + iter_stride * iter_index * width;
@@ -56,11 +71,48 @@ size_t dimension_t::getSize() const {
     return iter_size;
 }
 
+size_t dimension_t::getRemainingIterations() const {
+    return iter_size > 0 && iter_index < size_t(iter_size) ? iter_size - iter_index : 0;
+}
+
+bool dimension_t::isUnitStride() const {
+    return iter_stride == 1;
+}
+
+/* Advances the iteration index by n without touching the EOD flag. Only valid
+when the n skipped iterations are not the last one of the dimension */
+void dimension_t::skipIterations(size_t n) {
+    iter_index += n;
+}
+
+void dimension_t::saveState(stateWriter_t &w) const {
+    w.put<std::uint64_t>(offset);
+    w.put<std::uint64_t>(size);
+    w.put<std::int32_t>(stride);
+    w.put<std::int32_t>(iter_offset);
+    w.put<std::int32_t>(iter_size);
+    w.put<std::int32_t>(iter_stride);
+    w.put<std::uint64_t>(iter_index);
+    w.put<std::uint8_t>(endOfDimension);
+}
+
+void dimension_t::restoreState(stateReader_t &r) {
+    offset = r.get<std::uint64_t>();
+    size = r.get<std::uint64_t>();
+    stride = r.get<std::int32_t>();
+    iter_offset = r.get<std::int32_t>();
+    iter_size = r.get<std::int32_t>();
+    iter_stride = r.get<std::int32_t>();
+    iter_index = r.get<std::uint64_t>();
+    storeEndOfDimension(r.get<std::uint8_t>());
+}
+
 /* Start of modifier_t function definitions */
 
-void staticModifier_t::modDimension(std::deque<dimension_t> &dims, const size_t elementWidth) {
+void staticModifier_t::modDimension(std::span<dimension_t> dims, const size_t elementWidth) {
     int valueChange = behaviour == staticBehaviour::Increment ? displacement : -1 * displacement;
-    dimension_t &dim = dims.at(targetDim);
+    assert_msg("Modifier targets a dimension that was not configured", size_t(targetDim) < dims.size());
+    dimension_t &dim = dims[targetDim];
 
     if (target == Target::Offset) {
         dim.iter_offset += valueChange * elementWidth;
@@ -123,9 +175,14 @@ void dynamicModifier_t::getIndirectRegisterValues() {
     // std::cout << "indirectRegisterValue: " << indirectRegisterValue << std::endl;
 }
 
-void dynamicModifier_t::modDimension(std::deque<dimension_t> &dims, const size_t elementWidth) {
+void dynamicModifier_t::reserveIndices(size_t n) const {
+    std::visit([n](auto &reg) { reg.reserveIndices(n); }, su->registers.at(sourceStream));
+}
+
+bool dynamicModifier_t::modDimension(std::span<dimension_t> dims, const size_t elementWidth) {
     // size_t valueChange = behaviour == Behaviour::Increment ? displacement : -1*displacement;
-    dimension_t &dim = dims.at(targetDim);
+    assert_msg("Modifier targets a dimension that was not configured", size_t(targetDim) < dims.size());
+    dimension_t &dim = dims[targetDim];
     if (!sourceEnd) {
         getIndirectRegisterValues();
 
@@ -148,12 +205,13 @@ void dynamicModifier_t::modDimension(std::deque<dimension_t> &dims, const size_t
         }
 
         modApplied = true;
-
-    } else {
-        dim.setEndOfDimension(true);
-        sourceEnd = false;
-        // std::cout << "ACABOU\n";
+        return true;
     }
+
+    dim.setEndOfDimension(true);
+    sourceEnd = false;
+    // std::cout << "ACABOU\n";
+    return false;
 }
 
 void scatterGModifier_t::calculateValueChange(auto &target, auto baseValue, dynamicBehaviour behaviour, int valueChange) {
@@ -191,7 +249,7 @@ void scatterGModifier_t::getIndirectRegisterValues() {
     // std::cout << "sgRegisterValue: " << indirectRegisterValue << std::endl;
 }
 
-void scatterGModifier_t::modDimension(dimension_t &dim, const size_t elementWidth) {
+bool scatterGModifier_t::modDimension(dimension_t &dim, const size_t elementWidth) {
     // size_t valueChange = behaviour == Behaviour::Increment ? displacement : -1*displacement;
     if (!sourceEnd) {
         getIndirectRegisterValues();
@@ -210,12 +268,471 @@ void scatterGModifier_t::modDimension(dimension_t &dim, const size_t elementWidt
         std::cout << "iter_offset: " << dim.iter_offset << std::endl;*/
 
         modApplied = true;
+        return true;
+    }
 
-    } else {
-        dim.setEndOfDimension(true);
-        // sourceEnd = false;
-        // std::cout << "ACABOU sg\n";
+    dim.setEndOfDimension(true);
+    // sourceEnd = false;
+    // std::cout << "ACABOU sg\n";
+    return false;
+}
+
+void staticModifier_t::saveState(stateWriter_t &w) const {
+    w.put<std::uint8_t>(std::uint8_t(target));
+    w.put<std::uint8_t>(std::uint8_t(behaviour));
+    w.put<std::int32_t>(displacement);
+    w.put<std::uint8_t>(targetDim);
+}
+
+staticModifier_t staticModifier_t::restoreState(stateReader_t &r) {
+    const auto t = r.getEnum<Target>(3);
+    const auto b = r.getEnum<staticBehaviour>(2);
+    const int d = r.get<std::int32_t>();
+    return staticModifier_t(t, b, d, r.getCount<std::uint8_t>(descriptorIterator_t::maxDimensions - 1));
+}
+
+void dynamicModifier_t::saveState(stateWriter_t &w) const {
+    w.put<std::uint8_t>(std::uint8_t(target));
+    w.put<std::uint8_t>(std::uint8_t(behaviour));
+    w.put<std::uint8_t>(sourceStream);
+    w.put<std::uint8_t>(targetDim);
+    w.put<std::uint8_t>(modApplied);
+    w.put<std::int32_t>(indirectRegisterValue);
+    w.put<std::uint8_t>(sourceEnd);
+}
+
+dynamicModifier_t dynamicModifier_t::restoreState(stateReader_t &r, streamingUnit_t *su) {
+    const auto t = r.getEnum<Target>(3);
+    const auto b = r.getEnum<dynamicBehaviour>(5);
+    const size_t src = r.getCount<std::uint8_t>(streamingUnit_t::registerCount - 1);
+    dynamicModifier_t mod(t, b, src, su, r.getCount<std::uint8_t>(descriptorIterator_t::maxDimensions - 1));
+    mod.modApplied = r.get<std::uint8_t>();
+    mod.indirectRegisterValue = r.get<std::int32_t>();
+    mod.sourceEnd = r.get<std::uint8_t>();
+    return mod;
+}
+
+void scatterGModifier_t::saveState(stateWriter_t &w) const {
+    w.put<std::uint8_t>(std::uint8_t(behaviour));
+    w.put<std::uint8_t>(sourceStream);
+    w.put<std::uint8_t>(modApplied);
+    w.put<std::int32_t>(indirectRegisterValue);
+    w.put<std::uint8_t>(sourceEnd);
+}
+
+scatterGModifier_t scatterGModifier_t::restoreState(stateReader_t &r, streamingUnit_t *su) {
+    const auto b = r.getEnum<dynamicBehaviour>(5);
+    scatterGModifier_t mod(b, r.getCount<std::uint8_t>(streamingUnit_t::registerCount - 1), su);
+    mod.modApplied = r.get<std::uint8_t>();
+    mod.indirectRegisterValue = r.get<std::int32_t>();
+    mod.sourceEnd = r.get<std::uint8_t>();
+    return mod;
+}
+
+/* Start of descriptorIterator_t function definitions */
+
+void descriptorIterator_t::startConfiguration(size_t base_address, size_t width) {
+    shapeReused = dimensionCount != 0 && width == elementWidth;
+    previousDimensionCount = dimensionCount;
+    previousVecCfgDim = vecCfgDim;
+    staticMatched.fill(0);
+    dynamicMatched.fill(0);
+    scatterGMatched = 0;
+
+    baseAddress = base_address;
+    elementWidth = width;
+    dimensionCount = 0;
+    vecCfgDim = 0;
+    activity = activity_t{};
+    stale = true;
+}
+
+void descriptorIterator_t::addDimension(const dimension_t &dim) {
+    assert_msg("Cannot append more dimensions as the max value was reached", dimensionCount < maxDimensions);
+    if (dimensionCount)
+        dropUnmatchedModifiers(dimensionCount - 1);
+    dimensions.assign(dimensionCount++, dim);
+}
+
+/* Modifiers matching the previous configuration are kept in place, so
+re-configuring a stream does not build them again */
+void descriptorIterator_t::addStaticModifier(const staticModifier_t &mod) {
+    // a modifier appended before any dimension is never triggered
+    if (!dimensionCount)
+        return;
+    auto &mods = staticModifiers[dimensionCount - 1];
+    size_t &matched = staticMatched[dimensionCount - 1];
+    if (matched < mods.size() && mods[matched].hasSameConfiguration(mod)) {
+        matched++;
+        return;
+    }
+    while (mods.size() > matched)
+        mods.pop_back();
+    mods.push_back(mod);
+    matched++;
+    shapeReused = false;
+}
+
+void descriptorIterator_t::addDynamicModifier(const dynamicModifier_t &mod) {
+    if (!dimensionCount)
+        return;
+    auto &mods = dynamicModifiers[dimensionCount - 1];
+    size_t &matched = dynamicMatched[dimensionCount - 1];
+    if (matched < mods.size() && mods[matched].hasSameConfiguration(mod)) {
+        mods[matched++].restart();
+        return;
+    }
+    while (mods.size() > matched)
+        mods.pop_back();
+    mods.push_back(mod);
+    matched++;
+    shapeReused = false;
+}
+
+void descriptorIterator_t::addScatterGModifier(const scatterGModifier_t &mod) {
+    if (scatterGMatched < scatterGModifiers.size() && scatterGModifiers[scatterGMatched].hasSameConfiguration(mod)) {
+        scatterGModifiers[scatterGMatched++].restart();
+        return;
+    }
+    while (scatterGModifiers.size() > scatterGMatched)
+        scatterGModifiers.pop_back();
+    scatterGModifiers.push_back(mod);
+    scatterGMatched++;
+    shapeReused = false;
+}
+
+void descriptorIterator_t::dropUnmatchedModifiers(size_t dim) {
+    if (staticModifiers[dim].size() > staticMatched[dim] || dynamicModifiers[dim].size() > dynamicMatched[dim])
+        shapeReused = false;
+    while (staticModifiers[dim].size() > staticMatched[dim])
+        staticModifiers[dim].pop_back();
+    while (dynamicModifiers[dim].size() > dynamicMatched[dim])
+        dynamicModifiers[dim].pop_back();
+}
+
+void descriptorIterator_t::configureVecDim(const int cfgIndex) {
+    vecCfgDim = cfgIndex;
+}
+
+void descriptorIterator_t::endConfiguration() {
+    // Modifiers left over from a previous configuration with more dimensions are dropped too
+    for (size_t i = dimensionCount ? dimensionCount - 1 : 0; i < maxDimensions; i++)
+        dropUnmatchedModifiers(i);
+    if (scatterGModifiers.size() > scatterGMatched)
+        shapeReused = false;
+    while (scatterGModifiers.size() > scatterGMatched)
+        scatterGModifiers.pop_back();
+
+    // If vecCfgDim is -1, then the innermost dimension is the vector coupled dimension
+    if (vecCfgDim == -1)
+        vecCfgDim = dimensionCount - 1;
+    shapeReused &= dimensionCount == previousDimensionCount && vecCfgDim == previousVecCfgDim;
+
+    // Apply all dynamic modifiers for the first iteration, once their indices are in
+    reserveIndices();
+    for (size_t i = 0; i < dimensionCount; i++)
+        for (auto it = dynamicModifiers[i].rbegin(); it != dynamicModifiers[i].rend(); ++it) {
+            activity.indexFetches += it->modDimension(activeDimensions(), elementWidth);
+            activity.modifierApplications++;
+        }
+
+    stale = true;
+}
+
+bool descriptorIterator_t::isStreamDone() const {
+    return dimensionCount == 0 || dimensions[0].isEndOfDimension();
+}
+
+std::span<dimension_t> descriptorIterator_t::activeDimensions() {
+    return std::span<dimension_t>(dimensions.data(), dimensionCount);
+}
+
+void descriptorIterator_t::refresh() {
+    if (!stale)
+        return;
+    outerAddress = baseAddress;
+    anyEmpty = false;
+    for (size_t i = 0; i < dimensionCount; i++) {
+        if (i + 1 < dimensionCount)
+            outerAddress += dimensions[i].calcAddress(elementWidth);
+        anyEmpty |= dimensions[i].isEmpty();
     }
+    stale = false;
+}
+
+size_t descriptorIterator_t::generateAddress() {
+    /* A dimension in its last iteration ends once all the dimensions inside it
+    have ended, so the walk stops at the first dimension that has not */
+    for (int i = int(dimensionCount - 1); i >= 0; i--) {
+        dimension_t &dim = dimensions[i];
+        if (dim.isLastIteration())
+            dim.setEndOfDimension(true);
+        if (!dim.isEndOfDimension())
+            break;
+    }
+    refresh();
+    return outerAddress + dimensions[dimensionCount - 1].calcAddress(elementWidth);
+}
+
+void descriptorIterator_t::applySGMods() {
+    for (auto it = scatterGModifiers.rbegin(); it != scatterGModifiers.rend(); ++it)
+        if (!it->isApplied()) {
+            activity.indexFetches += it->modDimension(dimensions[0], elementWidth);
+            activity.modifierApplications++;
+            stale = true;
+        }
+}
+
+void descriptorIterator_t::setSGModsNotApplied() {
+    for (auto &mod : scatterGModifiers)
+        mod.setApplied(false);
+}
+
+bool descriptorIterator_t::tryGenerateAddress(size_t &address) {
+    /* There are two situations that prevent us from generating offsets/iterating a stream:
+    1) A dimension is empty, in which case it and all the dimensions inside it end
+    2) We just finished the last iteration of the vector coupled dimension. In these
+    cases, the generation can only resume after the stream is iterated */
+    const int inner = int(dimensionCount - 1);
+    bool canGenerateAddress = true;
+
+    refresh();
+    /* With no empty dimension and the innermost one still running, neither
+    situation can happen and only scatter-gather modifiers need attention */
+    if (anyEmpty || dimensions[inner].isEndOfDimension() || !scatterGModifiers.empty()) {
+        bool innerDone = true;
+        for (int i = inner; i >= 0; i--) {
+            if (i == 0)
+                applySGMods();
+            if (dimensions[i].isEmpty()) {
+                for (int j = i; j <= inner; j++)
+                    dimensions[j].setEndOfDimension(true);
+                canGenerateAddress = false;
+                innerDone = true;
+            }
+            innerDone = innerDone && dimensions[i].isEndOfDimension();
+            if (i == vecCfgDim && innerDone) {
+                canGenerateAddress = false;
+                break;
+            }
+        }
+    }
+
+    address = generateAddress();
+    return canGenerateAddress;
+}
+
+/* Every dynamic modifier may be applied by an update that wraps the innermost
+dimension, so their sources fetch as many indices as they can be asked for */
+void descriptorIterator_t::reserveIndices() {
+    for (size_t i = 0; i < dimensionCount; i++)
+        for (size_t j = 0; j < dynamicModifiers[i].size(); j++) {
+            const dynamicModifier_t &mod = dynamicModifiers[i][j];
+            size_t shared = 0;
+            for (size_t k = 0; k <= i; k++)
+                for (size_t l = 0; l < (k == i ? j + 1 : dynamicModifiers[k].size()); l++)
+                    shared += mod.hasSameSource(dynamicModifiers[k][l]);
+            mod.reserveIndices(shared);
+        }
+}
+
+void descriptorIterator_t::updateIteration() {
+    /* Index fetches may trap, so they are made before anything changes and
+    the update can be retried as a whole */
+    if (dimensions[dimensionCount - 1].isEndOfDimension())
+        reserveIndices();
+
+    /* Iteration starts from the innermost dimension and updates the next if the current reaches an overflow */
+    bool validIter = dimensions[dimensionCount - 1].advance();
+
+    for (int i = int(dimensionCount - 1); i > 0; --i) {
+        dimension_t &currDim = dimensions[i];
+        /* The following calculations are only necessary if we ARE in the
+        last iteration of a dimension */
+        if (!currDim.isEndOfDimension())
+            continue;
+
+        stale = true;
+
+        // If modifiers exist, the values at targetted dimensions might have been modified.
+        // As such, we need to reset them before next iteration.
+        if (validIter)
+            for (auto it = staticModifiers[i].rbegin(); it != staticModifiers[i].rend(); ++it)
+                dimensions[it->getTargetDim()].resetIterValues();
+
+        // Reset EOD flag of current dimension if iteration was successful
+        currDim.setEndOfDimension(false);
+
+        // Iterate upper dimension
+        dimension_t &nextDim = dimensions[i - 1];
+        validIter = nextDim.advance();
+
+        if (validIter) {
+            // Apply static modifiers associated with upper dimension to target dimensions
+            for (auto it = staticModifiers[i - 1].rbegin(); it != staticModifiers[i - 1].rend(); ++it) {
+                it->modDimension(activeDimensions(), elementWidth);
+                activity.modifierApplications++;
+            }
+
+            // Apply dynamic modifiers associated with upper dimension to target dimensions
+            for (auto it = dynamicModifiers[i - 1].rbegin(); it != dynamicModifiers[i - 1].rend(); ++it) {
+                if (nextDim.isLastIteration())
+                    nextDim.resetIterValues();
+                activity.indexFetches += it->modDimension(activeDimensions(), elementWidth);
+                activity.modifierApplications++;
+            }
+        }
+    }
+}
+
+void descriptorIterator_t::finish() {
+    for (size_t i = 0; i < dimensionCount; i++)
+        dimensions[i].setEndOfDimension(true);
+}
+
+/* Counts how many elements, starting at the current iteration, can be moved
+with a single host copy. The run must stay inside a unit-stride innermost
+dimension and stops one element short of both the end of that dimension and
+the given limit, so that the per-element path still handles the access that
+raises EOD flags or fills the register. Streams with scatter-gather modifiers
+or with any dimension already flagged (EOD or empty) are left to the
+per-element path. Static and dynamic modifiers are only applied when an outer
+dimension advances, which happens outside of the run. */
+size_t descriptorIterator_t::contiguousRunLength(const size_t limit, size_t &address) {
+    if (dimensionCount == 0 || !scatterGModifiers.empty())
+        return 0;
+
+    const dimension_t &inner = dimensions[dimensionCount - 1];
+    if (!inner.isUnitStride())
+        return 0;
+
+    size_t run = std::min(limit, inner.getRemainingIterations());
+    if (run < 3)
+        return 0;
+
+    refresh();
+    if (anyEmpty)
+        return 0;
+    for (size_t i = 0; i < dimensionCount; i++)
+        if (dimensions[i].isEndOfDimension())
+            return 0;
+
+    /* The innermost dimension is not in its last iteration, so no EOD flag is raised here */
+    address = generateAddress();
+    if (address % elementWidth)
+        return 0;
+
+    return run - 1;
+}
+
+void descriptorIterator_t::skipIterations(size_t n) {
+    dimensions[dimensionCount - 1].skipIterations(n);
+}
+
+size_t descriptorIterator_t::getDimensionCount() const {
+    return dimensionCount;
+}
+
+bool descriptorIterator_t::isEndOfDimension(size_t i) const {
+    assert_msg("Trying to check EOD of invalid dimension", i < dimensionCount);
+    return (dimensions.endOfDimensionMask >> i) & 1;
+}
+
+/* EOD flags of the configured dimensions, bit i holding the flag of dimension i */
+uint8_t descriptorIterator_t::getEndOfDimensionMask() const {
+    return dimensions.endOfDimensionMask & ((1u << dimensionCount) - 1);
+}
+
+bool descriptorIterator_t::isEmpty() const {
+    return dimensionCount == 0 && previousDimensionCount == 0 && scatterGModifiers.empty();
+}
+
+bool descriptorIterator_t::isShapeReused() const {
+    return shapeReused;
+}
+
+bool descriptorIterator_t::isAffine() const {
+    if (!scatterGModifiers.empty())
+        return false;
+    for (size_t i = 0; i < dimensionCount; i++)
+        if (!dynamicModifiers[i].empty())
+            return false;
+    return true;
+}
+
+descriptorIterator_t::activity_t descriptorIterator_t::takeActivity() {
+    return std::exchange(activity, activity_t{});
+}
+
+/* Only the dimensions configured are saved. Modifiers are saved up to the
+deepest of the current and the previous configuration, as a configuration in
+progress still matches the ones of the previous one. The cached address is
+recomputed after restoring */
+void descriptorIterator_t::saveState(stateWriter_t &w) const {
+    w.put<std::uint8_t>(dimensionCount);
+    w.put<std::uint64_t>(baseAddress);
+    w.put<std::uint8_t>(elementWidth);
+    w.put<std::int8_t>(vecCfgDim);
+    for (size_t i = 0; i < dimensionCount; i++)
+        dimensions[i].saveState(w);
+
+    w.put<std::uint8_t>(previousDimensionCount);
+    w.put<std::int8_t>(previousVecCfgDim);
+    w.put<std::uint8_t>(shapeReused);
+    const size_t modifierDimensions = std::max(dimensionCount, previousDimensionCount);
+    for (size_t i = 0; i < modifierDimensions; i++) {
+        w.put<std::uint16_t>(staticModifiers[i].size());
+        for (auto &mod : staticModifiers[i])
+            mod.saveState(w);
+        w.put<std::uint16_t>(staticMatched[i]);
+        w.put<std::uint16_t>(dynamicModifiers[i].size());
+        for (auto &mod : dynamicModifiers[i])
+            mod.saveState(w);
+        w.put<std::uint16_t>(dynamicMatched[i]);
+    }
+    w.put<std::uint16_t>(scatterGModifiers.size());
+    for (auto &mod : scatterGModifiers)
+        mod.saveState(w);
+    w.put<std::uint16_t>(scatterGMatched);
+}
+
+void descriptorIterator_t::restoreState(stateReader_t &r, streamingUnit_t *su) {
+    dimensionCount = r.getCount<std::uint8_t>(maxDimensions);
+    baseAddress = r.get<std::uint64_t>();
+    elementWidth = r.get<std::uint8_t>();
+    r.check(elementWidth == 1 || elementWidth == 2 || elementWidth == 4 || elementWidth == 8);
+    vecCfgDim = r.get<std::int8_t>();
+    for (size_t i = 0; i < maxDimensions; i++) {
+        if (i < dimensionCount)
+            dimensions[i].restoreState(r);
+        else
+            dimensions.assign(i, dimension_t());
+    }
+
+    previousDimensionCount = r.getCount<std::uint8_t>(maxDimensions);
+    previousVecCfgDim = r.get<std::int8_t>();
+    shapeReused = r.get<std::uint8_t>();
+    const size_t modifierDimensions = std::max(dimensionCount, previousDimensionCount);
+    for (size_t i = 0; i < maxDimensions; i++) {
+        staticModifiers[i].clear();
+        dynamicModifiers[i].clear();
+        staticMatched[i] = dynamicMatched[i] = 0;
+        if (i >= modifierDimensions)
+            continue;
+        for (size_t n = r.get<std::uint16_t>(); n && !r.failed; n--)
+            staticModifiers[i].push_back(staticModifier_t::restoreState(r));
+        staticMatched[i] = r.getCount<std::uint16_t>(staticModifiers[i].size());
+        for (size_t n = r.get<std::uint16_t>(); n && !r.failed; n--)
+            dynamicModifiers[i].push_back(dynamicModifier_t::restoreState(r, su));
+        dynamicMatched[i] = r.getCount<std::uint16_t>(dynamicModifiers[i].size());
+    }
+    scatterGModifiers.clear();
+    for (size_t n = r.get<std::uint16_t>(); n && !r.failed; n--)
+        scatterGModifiers.push_back(scatterGModifier_t::restoreState(r, su));
+    scatterGMatched = r.getCount<std::uint16_t>(scatterGModifiers.size());
+
+    activity = activity_t{};
+    stale = true;
 }
 
 /*void modifier_t::printModifier() const {
@@ -2,12 +2,15 @@
 #define DIMENSION_HPP
 
 #include "helpers.h"
+#include <span>
 //#include "streaming_unit.h"
 
 class streamingUnit_t;
+struct stateWriter_t;
+struct stateReader_t;
 
 struct dimension_t {
-    dimension_t(size_t offset, size_t size, int stride)
+    dimension_t(size_t offset = 0, size_t size = 0, int stride = 0)
         : offset(offset), size(size), stride(stride) {
 
         iter_offset = offset;
@@ -30,18 +33,32 @@ struct dimension_t {
     bool isModApplied() const;
     bool isEndOfDimension() const;
     void setEndOfDimension(bool b);
+    void bindEndOfDimensionFlag(uint8_t *mask, size_t bit);
     size_t calcAddress(size_t width) const;
     size_t getSize() const;
+    size_t getRemainingIterations() const;
+    bool isUnitStride() const;
+    void skipIterations(size_t n);
+
+    /* Saved state of the dimension, iteration included. Restoring keeps the
+    EOD flag the dimension is bound to */
+    void saveState(stateWriter_t &w) const;
+    void restoreState(stateReader_t &r);
 
 private:
-    const size_t offset;
-    const size_t size;
-    const int stride;
+    size_t offset;
+    size_t size;
+    int stride;
     int iter_offset;
     int iter_size;
     int iter_stride;
     size_t iter_index;
     bool endOfDimension;
+    /* When bound, the EOD flag is mirrored to this bit of the owner's mask */
+    uint8_t *eodMask = nullptr;
+    uint8_t eodBit = 0;
+
+    void storeEndOfDimension(bool b);
 
     //friend class modifier_t;
 	friend class staticModifier_t;
@@ -73,12 +90,19 @@ struct staticModifier_t {
         :target(t), behaviour(b), displacement(d), targetDim(td) {
     }
 
-	void modDimension(std::deque<dimension_t> &dims, const size_t elementWidth);
+	void modDimension(std::span<dimension_t> dims, const size_t elementWidth);
 
     int getTargetDim() const {
         return targetDim;
     }
 
+    bool hasSameConfiguration(const staticModifier_t &other) const {
+        return target == other.target && behaviour == other.behaviour && displacement == other.displacement && targetDim == other.targetDim;
+    }
+
+    void saveState(stateWriter_t &w) const;
+    static staticModifier_t restoreState(stateReader_t &r);
+
 private:
     const Target target;
     const staticBehaviour behaviour;
@@ -95,7 +119,15 @@ struct dynamicModifier_t {
             modApplied = false;
         }
 
-	void modDimension(std::deque<dimension_t> &dims, const size_t elementWidth);
+	/* Returns whether an index was fetched from the source stream */
+	bool modDimension(std::span<dimension_t> dims, const size_t elementWidth);
+
+	/* Has the source stream fetch the next n indices ahead */
+	void reserveIndices(size_t n) const;
+
+	bool hasSameSource(const dynamicModifier_t &other) const {
+		return sourceStream == other.sourceStream;
+	}
 
     bool isApplied() const {
         return modApplied;
@@ -109,6 +141,22 @@ struct dynamicModifier_t {
         return targetDim;
     }
 
+    bool hasSameConfiguration(const dynamicModifier_t &other) const {
+        return target == other.target && behaviour == other.behaviour && sourceStream == other.sourceStream && su == other.su && targetDim == other.targetDim;
+    }
+
+    /* Saved state of the modifier, which is restored to read from the
+    streams of su */
+    void saveState(stateWriter_t &w) const;
+    static dynamicModifier_t restoreState(stateReader_t &r, streamingUnit_t *su);
+
+    /* Forgets the state of a previous walk of the stream */
+    void restart() {
+        indirectRegisterValue = 0;
+        sourceEnd = false;
+        modApplied = false;
+    }
+
 private:
     const Target target;
     const dynamicBehaviour behaviour;
@@ -135,7 +183,8 @@ struct scatterGModifier_t {
             modApplied = false;
         }
 
-	void modDimension(dimension_t &dim, const size_t elementWidth);
+	/* Returns whether an index was fetched from the source stream */
+	bool modDimension(dimension_t &dim, const size_t elementWidth);
 
     bool isApplied() const {
         return modApplied;
@@ -145,6 +194,20 @@ struct scatterGModifier_t {
         modApplied = s;
     }
 
+    bool hasSameConfiguration(const scatterGModifier_t &other) const {
+        return behaviour == other.behaviour && sourceStream == other.sourceStream && su == other.su;
+    }
+
+    void saveState(stateWriter_t &w) const;
+    static scatterGModifier_t restoreState(stateReader_t &r, streamingUnit_t *su);
+
+    /* Forgets the state of a previous walk of the stream */
+    void restart() {
+        indirectRegisterValue = 0;
+        sourceEnd = false;
+        modApplied = false;
+    }
+
 private:
     const Target target = Target::Offset; // Only offset is supported for now
     const dynamicBehaviour behaviour;
@@ -161,4 +224,152 @@ private:
     void getIndirectRegisterValues();
 };
 
+/* A stream descriptor lowered into a flat, fixed-capacity form. Dimensions
+live in a std::array and modifiers are indexed by the dimension whose
+iteration triggers them, so walking the stream never searches a container.
+The address contribution of every dimension but the innermost one is cached
+and only recomputed after an outer dimension changes, which makes generating
+the next address O(1) amortised.
+
+Dimension 0 is the outermost one and the last dimension added is the
+innermost one, which is the first to be iterated.
+
+A configuration starts from whatever the descriptor held before, which is
+matched against the dimensions and modifiers appended to it. When the shape
+repeats, the modifiers already lowered are kept and only the base address and
+the dimension values are rebound. */
+struct descriptorIterator_t {
+    static constexpr size_t maxDimensions = 8;
+
+    void startConfiguration(size_t base_address, size_t width);
+    void addDimension(const dimension_t &dim);
+    void addStaticModifier(const staticModifier_t &mod);
+    void addDynamicModifier(const dynamicModifier_t &mod);
+    void addScatterGModifier(const scatterGModifier_t &mod);
+    void configureVecDim(const int cfgIndex);
+    void endConfiguration();
+
+    bool isStreamDone() const;
+    bool tryGenerateAddress(size_t &address);
+    void updateIteration();
+    void setSGModsNotApplied();
+    void finish();
+
+    size_t contiguousRunLength(const size_t limit, size_t &address);
+    void skipIterations(size_t n);
+
+    size_t getDimensionCount() const;
+    bool isEndOfDimension(size_t i) const;
+    uint8_t getEndOfDimensionMask() const;
+
+    /* Whether the descriptor holds no dimensions or modifiers, neither
+    configured nor left over from a previous configuration */
+    bool isEmpty() const;
+
+    /* Whether the last configuration only differed from the previous one in
+    its base address and dimension values */
+    bool isShapeReused() const;
+
+    /* Whether the addresses of the stream only depend on its descriptor, with
+    no modifier reading them from another stream */
+    bool isAffine() const;
+
+    /* Modifier work done while walking the stream, for the counters of the
+    streaming unit */
+    struct activity_t {
+        size_t modifierApplications = 0;
+        size_t indexFetches = 0;
+    };
+
+    /* Returns the activity since the previous call and clears it */
+    activity_t takeActivity();
+
+    /* Saved state of the descriptor: its dimensions and modifiers, where the
+    walk of the stream is, and the progress of a configuration that has not
+    ended yet. Activity is not part of it. Modifiers are restored to read from
+    the streams of su */
+    void saveState(stateWriter_t &w) const;
+    void restoreState(stateReader_t &r, streamingUnit_t *su);
+
+private:
+    static_assert(maxDimensions <= 8, "EOD flags of a stream must fit in a byte");
+
+    /* The dimensions of the stream and their EOD flags packed in a mask, bit i
+    holding the flag of dimension i. The mask is kept up to date by the
+    dimensions themselves, and copies bind their dimensions to their own mask */
+    struct dimensionSet_t {
+        std::array<dimension_t, maxDimensions> dims;
+        uint8_t endOfDimensionMask = 0;
+
+        dimensionSet_t() {
+            bind();
+        }
+
+        dimensionSet_t(const dimensionSet_t &other) : dims(other.dims), endOfDimensionMask(other.endOfDimensionMask) {
+            bind();
+        }
+
+        dimensionSet_t &operator=(const dimensionSet_t &other) {
+            dims = other.dims;
+            endOfDimensionMask = other.endOfDimensionMask;
+            bind();
+            return *this;
+        }
+
+        void assign(size_t i, const dimension_t &dim) {
+            dims[i] = dim;
+            dims[i].bindEndOfDimensionFlag(&endOfDimensionMask, i);
+        }
+
+        dimension_t &operator[](size_t i) { return dims[i]; }
+        const dimension_t &operator[](size_t i) const { return dims[i]; }
+        dimension_t *data() { return dims.data(); }
+
+    private:
+        void bind() {
+            for (size_t i = 0; i < maxDimensions; i++)
+                dims[i].bindEndOfDimensionFlag(&endOfDimensionMask, i);
+        }
+    };
+
+    dimensionSet_t dimensions;
+    size_t dimensionCount = 0;
+    /* Modifiers are keyed by the dimension they were appended after. Modifiers
+    of the same dimension are applied in reverse order of configuration */
+    std::array<std::vector<staticModifier_t>, maxDimensions> staticModifiers;
+    std::array<std::vector<dynamicModifier_t>, maxDimensions> dynamicModifiers;
+    /* Scatter-gather modifiers always act on the outermost dimension */
+    std::vector<scatterGModifier_t> scatterGModifiers;
+
+    size_t baseAddress = 0;
+    size_t elementWidth = 1;
+    int vecCfgDim = 0;
+
+    /* Shape of the previous configuration, and how much of it the current one
+    matched so far. Modifiers of a dimension that were not matched by the time
+    the next dimension is appended are dropped */
+    size_t previousDimensionCount = 0;
+    int previousVecCfgDim = 0;
+    std::array<size_t, maxDimensions> staticMatched{};
+    std::array<size_t, maxDimensions> dynamicMatched{};
+    size_t scatterGMatched = 0;
+    bool shapeReused = false;
+
+    activity_t activity;
+
+    /* Base address plus the contribution of every dimension but the innermost
+    one, and whether any dimension is empty. Both only change when an outer
+    dimension is iterated or modified, which marks them as stale */
+    size_t outerAddress = 0;
+    bool anyEmpty = false;
+    bool stale = true;
+
+    std::span<dimension_t> activeDimensions();
+    void dropUnmatchedModifiers(size_t dim);
+    void refresh();
+    size_t generateAddress();
+    void applySGMods();
+    void reserveIndices();
+};
+
 #endif // DIMENSION_HPP
@@ -84,6 +84,7 @@
 #define MNSTATUS_NMIE       0x00000008
 #define MNSTATUS_MNPP       0x00001800
 #define MNSTATUS_MNPV       0x00000080
+#define MNSTATUS_MNPELP     0x00000200
 
 #define DCSR_XDEBUGVER      (15U<<28)
 #define DCSR_EXTCAUSE       (7<<24)
@@ -1588,6 +1589,12 @@
 #define MASK_SO_A_ADDE_ACC_SG 0xf1f0707f
 #define MATCH_SO_A_ADDE_ACC_US 0x2010002b
 #define MASK_SO_A_ADDE_ACC_US 0xf1f0707f
+#define MATCH_SO_A_ADDE_ACC_W_FP 0x7010102b
+#define MASK_SO_A_ADDE_ACC_W_FP 0xf1f0707f
+#define MATCH_SO_A_ADDE_ACC_W_SG 0x7010202b
+#define MASK_SO_A_ADDE_ACC_W_SG 0xf1f0707f
+#define MATCH_SO_A_ADDE_ACC_W_US 0x7010002b
+#define MASK_SO_A_ADDE_ACC_W_US 0xf1f0707f
 #define MATCH_SO_A_ADDE_FP 0x2000102b
 #define MASK_SO_A_ADDE_FP 0xf1f0707f
 #define MATCH_SO_A_ADDE_SG 0x2000202b
@@ -1632,6 +1639,12 @@
 #define MASK_SO_A_MAC_SG 0xf000707f
 #define MATCH_SO_A_MAC_US 0x3000402b
 #define MASK_SO_A_MAC_US 0xf000707f
+#define MATCH_SO_A_MAC_W_FP 0x7000502b
+#define MASK_SO_A_MAC_W_FP 0xf000707f
+#define MATCH_SO_A_MAC_W_SG 0x7000602b
+#define MASK_SO_A_MAC_W_SG 0xf000707f
+#define MATCH_SO_A_MAC_W_US 0x7000402b
+#define MASK_SO_A_MAC_W_US 0xf000707f
 #define MATCH_SO_A_MAX_FP 0x4000502b
 #define MASK_SO_A_MAX_FP 0xf000707f
 #define MATCH_SO_A_MAX_SG 0x4000602b
@@ -5550,6 +5563,9 @@ DECLARE_INSN(so_a_add_us, MATCH_SO_A_ADD_US, MASK_SO_A_ADD_US)
 DECLARE_INSN(so_a_adde_acc_fp, MATCH_SO_A_ADDE_ACC_FP, MASK_SO_A_ADDE_ACC_FP)
 DECLARE_INSN(so_a_adde_acc_sg, MATCH_SO_A_ADDE_ACC_SG, MASK_SO_A_ADDE_ACC_SG)
 DECLARE_INSN(so_a_adde_acc_us, MATCH_SO_A_ADDE_ACC_US, MASK_SO_A_ADDE_ACC_US)
+DECLARE_INSN(so_a_adde_acc_w_fp, MATCH_SO_A_ADDE_ACC_W_FP, MASK_SO_A_ADDE_ACC_W_FP)
+DECLARE_INSN(so_a_adde_acc_w_sg, MATCH_SO_A_ADDE_ACC_W_SG, MASK_SO_A_ADDE_ACC_W_SG)
+DECLARE_INSN(so_a_adde_acc_w_us, MATCH_SO_A_ADDE_ACC_W_US, MASK_SO_A_ADDE_ACC_W_US)
 DECLARE_INSN(so_a_adde_fp, MATCH_SO_A_ADDE_FP, MASK_SO_A_ADDE_FP)
 DECLARE_INSN(so_a_adde_sg, MATCH_SO_A_ADDE_SG, MASK_SO_A_ADDE_SG)
 DECLARE_INSN(so_a_adde_us, MATCH_SO_A_ADDE_US, MASK_SO_A_ADDE_US)
@@ -5572,6 +5588,9 @@ DECLARE_INSN(so_a_inc_us, MATCH_SO_A_INC_US, MASK_SO_A_INC_US)
 DECLARE_INSN(so_a_mac_fp, MATCH_SO_A_MAC_FP, MASK_SO_A_MAC_FP)
 DECLARE_INSN(so_a_mac_sg, MATCH_SO_A_MAC_SG, MASK_SO_A_MAC_SG)
 DECLARE_INSN(so_a_mac_us, MATCH_SO_A_MAC_US, MASK_SO_A_MAC_US)
+DECLARE_INSN(so_a_mac_w_fp, MATCH_SO_A_MAC_W_FP, MASK_SO_A_MAC_W_FP)
+DECLARE_INSN(so_a_mac_w_sg, MATCH_SO_A_MAC_W_SG, MASK_SO_A_MAC_W_SG)
+DECLARE_INSN(so_a_mac_w_us, MATCH_SO_A_MAC_W_US, MASK_SO_A_MAC_W_US)
 DECLARE_INSN(so_a_max_fp, MATCH_SO_A_MAX_FP, MASK_SO_A_MAX_FP)
 DECLARE_INSN(so_a_max_sg, MATCH_SO_A_MAX_SG, MASK_SO_A_MAX_SG)
 DECLARE_INSN(so_a_max_us, MATCH_SO_A_MAX_US, MASK_SO_A_MAX_US)
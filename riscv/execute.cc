@@ -12,6 +12,7 @@ static void commit_log_reset(processor_t* p)
   p->get_state()->log_reg_write.clear();
   p->get_state()->log_mem_read.clear();
   p->get_state()->log_mem_write.clear();
+  p->get_state()->log_stream_mem.clear();
 }
 
 static void commit_log_stash_privilege(processor_t* p)
@@ -59,6 +60,26 @@ static void commit_log_print_value(FILE *log_file, int width, uint64_t val)
   commit_log_print_value(log_file, width, &val);
 }
 
+// UVE stream registers show their element width, valid element count and
+// valid elements; predicate registers show one flag per register byte
+static void commit_log_print_uve_reg(FILE *log_file, processor_t *p, char prefix, int rd)
+{
+  if (prefix == 'p') {
+    fprintf(log_file, " p%-2d ", rd);
+    commit_log_print_value(log_file, p->SU.getRegisterLength(), p->SU.predicates.at(rd).getPredicate().words.data());
+    return;
+  }
+
+  p->SU.operateRegister(rd, [&](auto &reg) {
+    const size_t valid = reg.getValidElements();
+    fprintf(log_file, " u%-2d e%zu l%zu", rd, reg.getElementWidth() * 8, valid);
+    if (valid) {
+      fprintf(log_file, " ");
+      commit_log_print_value(log_file, valid * reg.getElementWidth() * 8, reg.getElementsView().data());
+    }
+  });
+}
+
 static void commit_log_print_insn(processor_t *p, reg_t pc, insn_t insn)
 {
   FILE *log_file = p->get_log_file();
@@ -66,6 +87,7 @@ static void commit_log_print_insn(processor_t *p, reg_t pc, insn_t insn)
   auto& reg = p->get_state()->log_reg_write;
   auto& load = p->get_state()->log_mem_read;
   auto& store = p->get_state()->log_mem_write;
+  auto& stream_mem = p->get_state()->log_stream_mem;
   int priv = p->get_state()->last_inst_priv;
   int xlen = p->get_state()->last_inst_xlen;
   int flen = p->get_state()->last_inst_flen;
@@ -110,6 +132,12 @@ static void commit_log_print_insn(processor_t *p, reg_t pc, insn_t insn)
       size = xlen;
       prefix = 'c';
       break;
+    case 5:
+      prefix = 'u';
+      break;
+    case 6:
+      prefix = 'p';
+      break;
     default:
       assert("can't been here" && 0);
       break;
@@ -124,6 +152,11 @@ static void commit_log_print_insn(processor_t *p, reg_t pc, insn_t insn)
         show_vec = true;
     }
 
+    if (prefix == 'u' || prefix == 'p') {
+      commit_log_print_uve_reg(log_file, p, prefix, rd);
+      continue;
+    }
+
     if (!is_vec) {
       if (prefix == 'c')
         fprintf(log_file, " c%d_%s ", rd, csr_name(rd));
@@ -147,6 +180,13 @@ static void commit_log_print_insn(processor_t *p, reg_t pc, insn_t insn)
     fprintf(log_file, " ");
     commit_log_print_value(log_file, std::get<2>(item) << 3, std::get<1>(item));
   }
+
+  // stream accesses are logged as runs: base, element count and stride
+  for (auto& run : stream_mem) {
+    fprintf(log_file, " mem u%d %c ", run.stream, run.store ? 'w' : 'r');
+    commit_log_print_value(log_file, xlen, run.addr);
+    fprintf(log_file, " n%" PRIu64 " s%" PRId64 " e%d", run.count, run.stride, run.size * 8);
+  }
   fprintf(log_file, "\n");
 }
 
@@ -204,7 +244,8 @@ static inline reg_t execute_insn_logged(processor_t* p, reg_t pc, insn_fetch_t f
 bool processor_t::slow_path() const
 {
   return debug || state.single_step != state.STEP_NONE || state.debug_mode ||
-         log_commits_enabled || histogram_enabled || in_wfi || check_triggers_icount;
+         log_commits_enabled || histogram_enabled || in_wfi || check_triggers_icount ||
+         SU.timing.has_value(); // the UVE timing model counts retired instructions
 }
 
 // fetch/decode/execute loop
@@ -285,6 +326,7 @@ void processor_t::step(size_t n)
           if (debug && !state.serialized)
             disasm(fetch.insn);
           pc = execute_insn_logged(this, pc, fetch);
+          SU.retireInstruction();
           advance_pc();
 
           // Resume from debug mode in critical error
@@ -366,8 +408,10 @@ void processor_t::step(size_t n)
 serialize:
     state.minstret->bump((state.mcountinhibit->read() & MCOUNTINHIBIT_IR) ? 0 : instret);
 
-    // Model a hart whose CPI is 1.
-    state.mcycle->bump((state.mcountinhibit->read() & MCOUNTINHIBIT_CY) ? 0 : instret);
+    // Model a hart whose CPI is 1, plus the cycles the UVE timing model
+    // estimates instructions stalled waiting on streams.
+    const reg_t stall_cycles = SU.takeStallCycles();
+    state.mcycle->bump((state.mcountinhibit->read() & MCOUNTINHIBIT_CY) ? 0 : instret + stall_cycles);
 
     n -= instret;
   }
@@ -5,9 +5,12 @@
 
 #define DECODE_MACRO_USAGE_LOGGED 0
 
+// UVE instructions let the streaming unit know where each of them starts, so
+// that stream accesses that trap can be retried exactly (see streaming_unit.h)
 #define PROLOGUE \
   reg_t npc = sext_xlen(pc + insn_length(OPCODE)); \
-  if (!p->extension_enabled(EXT_ZCA)) assume(insn_length(OPCODE) % 4 == 0)
+  if (!p->extension_enabled(EXT_ZCA)) assume(insn_length(OPCODE) % 4 == 0); \
+  if (UVE_INSN) p->SU.beginInstruction(pc)
 
 #define EPILOGUE \
   trace_opcode(p, OPCODE, insn); \
@@ -0,0 +1,52 @@
+auto streamReg = insn.uve_rd();
+auto &predReg = P.SU.predicates[insn.uve_pred()];
+
+/* The sum is accumulated in single precision for 8- and 16-bit sources, and
+in double precision for single-precision ones. 8-bit and bfloat16 elements are
+summed exactly and rounded once; the others are added in order in the
+destination type */
+auto baseBehaviour = [](auto &dest, auto &src, auto &pred, auto narrow, auto wide) {
+    using NarrowType = decltype(narrow);
+    using WideType = decltype(wide);
+    using StorageType = typename std::remove_reference_t<decltype(dest)>::ElementsType;
+    auto elements = src.getElements();
+    auto out = dest.getElementsView(); // for merging predication
+
+    out[0] = reduceWidening(elements, src.getValidElements(), pred, out[0], [](StorageType acc, size_t n, const auto &e) {
+        WideType value = readAS<WideType>(acc);
+        for (size_t k = 0; k < n; k++)
+            value += WideType(readAS<NarrowType>(e[k]));
+        return readAS<StorageType>(value);
+    });
+    dest.setMode(RegisterMode::Scalar);
+    dest.setElements(out);
+};
+
+auto bulkBehaviour = [&](auto &dest, auto &src, auto &pred) {
+    auto elements = src.getElements();
+    auto out = dest.getElementsView(); // for merging predication
+
+    out[0] = reduceWidening(elements, src.getValidElements(), pred, out[0], [&](std::uint32_t acc, size_t n, const auto &e) {
+        return bulkSumAccumulate(P.SU, acc, n, e);
+    });
+    dest.setMode(RegisterMode::Scalar);
+    dest.setElements(out);
+};
+
+/* If the destination register is not configured, it is built with elements
+twice as wide as those of the source, and no narrower than single precision */
+P.SU.configureWithWidth(streamReg, std::max(2 * P.SU.widthTags.at(insn.uve_rs1()), 4));
+
+std::visit(overloaded{
+               [&](StreamReg32 &dest, StreamReg8 &src) { bulkBehaviour(dest, src, predReg); },
+               [&](StreamReg32 &dest, StreamReg16 &src) {
+                   withFp16Type(P.SU, [&](auto extra) {
+                       if constexpr (std::is_same_v<decltype(extra), bfloat_t>)
+                           bulkBehaviour(dest, src, predReg);
+                       else
+                           baseBehaviour(dest, src, predReg, extra, float{});
+                   });
+               },
+               [&](StreamReg64 &dest, StreamReg32 &src) { baseBehaviour(dest, src, predReg, float{}, double{}); },
+               [&](auto &dest, auto &src) { assert_msg("Invoking so.a.adde.acc.w.fp with invalid parameter sizes", false); }},
+           P.SU.registers[streamReg], P.SU.registers[insn.uve_rs1()]);
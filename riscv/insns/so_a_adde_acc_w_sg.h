@@ -0,0 +1,32 @@
+auto streamReg = insn.uve_rd();
+auto &predReg = P.SU.predicates[insn.uve_pred()];
+
+/* The sum is accumulated in elements twice as wide as the source ones. The
+extra arguments give the source and destination computation types */
+auto baseBehaviour = [](auto &dest, auto &src, auto &pred, auto narrow, auto wide) {
+    using NarrowType = decltype(narrow);
+    using WideType = decltype(wide);
+    using StorageType = typename std::remove_reference_t<decltype(dest)>::ElementsType;
+    auto elements = src.getElements();
+    auto out = dest.getElementsView(); // for merging predication
+
+    out[0] = reduceWidening(elements, src.getValidElements(), pred, out[0], [](StorageType acc, size_t n, const auto &e) {
+        WideType value = readAS<WideType>(acc);
+        for (size_t k = 0; k < n; k++)
+            value += WideType(readAS<NarrowType>(e[k]));
+        return readAS<StorageType>(value);
+    });
+    dest.setMode(RegisterMode::Scalar);
+    dest.setElements(out);
+};
+
+/* If the destination register is not configured, it is built with elements
+twice as wide as those of the source */
+P.SU.configureWithWidth(streamReg, 2 * P.SU.widthTags.at(insn.uve_rs1()));
+
+std::visit(overloaded{
+               [&](StreamReg16 &dest, StreamReg8 &src) { baseBehaviour(dest, src, predReg, (signed char){}, (short int){}); },
+               [&](StreamReg32 &dest, StreamReg16 &src) { baseBehaviour(dest, src, predReg, (short int){}, int{}); },
+               [&](StreamReg64 &dest, StreamReg32 &src) { baseBehaviour(dest, src, predReg, int{}, (long int){}); },
+               [&](auto &dest, auto &src) { assert_msg("Invoking so.a.adde.acc.w.sg with invalid parameter sizes", false); }},
+           P.SU.registers[streamReg], P.SU.registers[insn.uve_rs1()]);
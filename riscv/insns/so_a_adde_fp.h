@@ -1,14 +1,10 @@
 // std::cout << "\n---ADDE---" << "\n";
 auto streamReg = insn.uve_rd();
-auto &destReg = P.SU.registers[streamReg];
-auto &srcReg = P.SU.registers[insn.uve_rs1()];
 auto &predReg = P.SU.predicates[insn.uve_pred()];
 
 // The extra argument is passed because we need to tell the lambda the computation type. In C++20 we would use a lambda template parameter, however in C++17 we don't have those. As such, we pass an extra value to later on infer its type and know the storage we need to use
 auto baseBehaviour = [](auto &dest, auto &src, auto &pred, auto extra) {
     auto elements = src.getElements();
-    auto destElements = dest.getElements(false);
-    auto pi = pred.getPredicate();
     auto validElementsIndex = src.getValidElements();
 
     using StorageType = typename std::remove_reference_t<decltype(dest)>::ElementsType;
@@ -16,17 +12,12 @@ auto baseBehaviour = [](auto &dest, auto &src, auto &pred, auto extra) {
 
     OperationType value = 0;
 
-    std::vector<StorageType> out = destElements; // ??
+    auto out = dest.getElementsView(); // for merging predication
 
     //std::cout << "ADDE   ";
 
-    for (size_t i = 0; i < validElementsIndex; i++) {
-        if (pi.at((i+1)*sizeof(OperationType)-1)){
-            //std::cout << readAS<OperationType>(elements.at(i)) << " + ";
-            value += readAS<OperationType>(elements.at(i));
-        }
-    }
-    out.at(0) = readAS<StorageType>(value);
+    value = reduceElements(elements, validElementsIndex, pred, value, [](OperationType acc, OperationType e) { return OperationType(acc + e); });
+    out[0] = readAS<StorageType>(value);
     dest.setMode(RegisterMode::Scalar);
     dest.setElements(out);
 
@@ -34,21 +25,10 @@ auto baseBehaviour = [](auto &dest, auto &src, auto &pred, auto extra) {
 };
 
 // If the destination register is not configured, we have to build it before the operation so that its element size matches before any calculations are done
-std::visit([&](auto &dest) {
-    if (dest.getStatus() == RegisterStatus::NotConfigured) {
-        if (std::holds_alternative<StreamReg64>(srcReg)) {
-            P.SU.makeStreamRegister<std::uint64_t>(streamReg);
-            dest.endConfiguration();
-        } else if (std::holds_alternative<StreamReg32>(srcReg)) {
-            P.SU.makeStreamRegister<std::uint32_t>(streamReg);
-            dest.endConfiguration();
-        } else
-            assert_msg("Trying to run so.a.adde.fp with invalid src type", false);
-    }
-}, destReg);
-
-std::visit(overloaded{
+P.SU.configureLike(streamReg, insn.uve_rs1());
+
+P.SU.dispatchByWidth(overloaded{
     [&](StreamReg64 &dest, StreamReg64 &src) { baseBehaviour(dest, src, predReg, double{}); },
     [&](StreamReg32 &dest, StreamReg32 &src) { baseBehaviour(dest, src, predReg, float{}); },
-    [&](auto &dest, auto &src) { assert_msg("Invoking so.a.adde.fp with invalid parameter sizes", false); }
-}, destReg, srcReg);
\ No newline at end of file
+    [&](StreamReg16 &dest, StreamReg16 &src) { withFp16Type(P.SU, [&](auto extra) { baseBehaviour(dest, src, predReg, extra); }); }
+}, streamReg, insn.uve_rs1());
\ No newline at end of file
@@ -1,11 +1,9 @@
 auto destReg = insn.uve_rd();
-auto &srcReg = P.SU.registers[insn.uve_rs1()];
 auto &predReg = P.SU.predicates[insn.uve_pred()];
 
 // The extra argument is passed because we need to tell the lambda the computation type. In C++20 we would use a lambda template parameter, however in C++17 we don't have those. As such, we pass an extra value to later on infer its type and know the storage we need to use
 auto baseBehaviour = [](auto &value, auto &src, auto &pred, auto extra) {
     auto elements = src.getElements();
-    auto pi = pred.getPredicate();
     auto validElementsIndex = src.getValidElements();
 
     using OperationType = decltype(extra);
@@ -13,18 +11,14 @@ auto baseBehaviour = [](auto &value, auto &src, auto &pred, auto extra) {
 
     OperationType acc = 0;
 
-    for (size_t i = 0; i < validElementsIndex; i++) {
-        if (pi.at((i+1)*sizeof(OperationType)-1))
-            acc += readAS<OperationType>(elements.at(i));
-    }
+    acc = reduceElements(elements, validElementsIndex, pred, acc, [](OperationType acc, OperationType e) { return OperationType(acc + e); });
 
     value = readAS<StorageType>(acc);
 };
 
-std::visit(overloaded{
+P.SU.dispatchByWidth(overloaded{
     [&](StreamReg8 &src) { uint8_t value = 0; baseBehaviour(destReg, src, predReg, (signed char){}); WRITE_REG(destReg, value); },
     [&](StreamReg16 &src) { uint16_t value = 0; baseBehaviour(destReg, src, predReg, (short int){}); WRITE_REG(destReg, value); },
     [&](StreamReg32 &src) { uint32_t value = 0; baseBehaviour(destReg, src, predReg, int{}); WRITE_REG(destReg, value); },
-    [&](StreamReg64 &src) { uint64_t value = 0; baseBehaviour(destReg, src, predReg, (long int){}); WRITE_REG(destReg, value); },
-    [&](auto &src) { assert_msg("Invoking so.a.adds.sg with invalid parameter sizes", false); }
-}, srcReg);
\ No newline at end of file
+    [&](StreamReg64 &src) { uint64_t value = 0; baseBehaviour(destReg, src, predReg, (long int){}); WRITE_REG(destReg, value); }
+}, insn.uve_rs1());
\ No newline at end of file
@@ -0,0 +1,44 @@
+auto streamReg = insn.uve_rd();
+auto &predReg = P.SU.predicates[insn.uve_pred()];
+
+/* Destination elements are wider than the source ones, so each lane of the
+destination accumulates the products of the source lanes it overlaps: four
+8-bit or two 16-bit ones into a single-precision lane, two single-precision ones
+into a double-precision lane. 8-bit and bfloat16 products are summed exactly
+and rounded once; the others are added in order in the destination type, into
+which their products fit exactly */
+auto baseBehaviour = [](auto &dest, auto &src1, auto &src2, auto &pred, auto narrow, auto wide) {
+    using NarrowType = decltype(narrow);
+    using WideType = decltype(wide);
+    using StorageType = typename std::remove_reference_t<decltype(dest)>::ElementsType;
+    streamWidening(dest, pred, [](StorageType acc, size_t n, const auto &a, const auto &b) {
+        WideType value = readAS<WideType>(acc);
+        for (size_t k = 0; k < n; k++)
+            value += WideType(readAS<NarrowType>(a[k])) * WideType(readAS<NarrowType>(b[k]));
+        return readAS<StorageType>(value);
+    }, src1, src2);
+};
+
+auto bulkBehaviour = [&](auto &dest, auto &src1, auto &src2, auto &pred) {
+    streamWidening(dest, pred, [&](std::uint32_t acc, size_t n, const auto &a, const auto &b) {
+        return bulkDotAccumulate(P.SU, acc, n, a, b);
+    }, src1, src2);
+};
+
+/* If the destination register is not configured, it is built with elements
+twice as wide as those of the sources, and no narrower than single precision */
+P.SU.configureWithWidth(streamReg, std::max(2 * P.SU.widthTags.at(insn.uve_rs1()), 4));
+
+std::visit(overloaded{
+               [&](StreamReg32 &dest, StreamReg8 &src1, StreamReg8 &src2) { bulkBehaviour(dest, src1, src2, predReg); },
+               [&](StreamReg32 &dest, StreamReg16 &src1, StreamReg16 &src2) {
+                   withFp16Type(P.SU, [&](auto extra) {
+                       if constexpr (std::is_same_v<decltype(extra), bfloat_t>)
+                           bulkBehaviour(dest, src1, src2, predReg);
+                       else
+                           baseBehaviour(dest, src1, src2, predReg, extra, float{});
+                   });
+               },
+               [&](StreamReg64 &dest, StreamReg32 &src1, StreamReg32 &src2) { baseBehaviour(dest, src1, src2, predReg, float{}, double{}); },
+               [&](auto &dest, auto &src1, auto &src2) { assert_msg("Invoking so.a.mac.w.fp with invalid parameter sizes", false); }},
+           P.SU.registers[streamReg], P.SU.registers[insn.uve_rs1()], P.SU.registers[insn.uve_rs2()]);
@@ -0,0 +1,28 @@
+auto streamReg = insn.uve_rd();
+auto &predReg = P.SU.predicates[insn.uve_pred()];
+
+/* Destination elements are twice as wide as the source ones, so each lane of
+the destination accumulates the products of the two source lanes it overlaps.
+The extra arguments give the source and destination computation types */
+auto baseBehaviour = [](auto &dest, auto &src1, auto &src2, auto &pred, auto narrow, auto wide) {
+    using NarrowType = decltype(narrow);
+    using WideType = decltype(wide);
+    using StorageType = typename std::remove_reference_t<decltype(dest)>::ElementsType;
+    streamWidening(dest, pred, [](StorageType acc, size_t n, const auto &a, const auto &b) {
+        WideType value = readAS<WideType>(acc);
+        for (size_t k = 0; k < n; k++)
+            value += WideType(readAS<NarrowType>(a[k])) * WideType(readAS<NarrowType>(b[k]));
+        return readAS<StorageType>(value);
+    }, src1, src2);
+};
+
+/* If the destination register is not configured, it is built with elements
+twice as wide as those of the sources */
+P.SU.configureWithWidth(streamReg, 2 * P.SU.widthTags.at(insn.uve_rs1()));
+
+std::visit(overloaded{
+               [&](StreamReg16 &dest, StreamReg8 &src1, StreamReg8 &src2) { baseBehaviour(dest, src1, src2, predReg, (signed char){}, (short int){}); },
+               [&](StreamReg32 &dest, StreamReg16 &src1, StreamReg16 &src2) { baseBehaviour(dest, src1, src2, predReg, (short int){}, int{}); },
+               [&](StreamReg64 &dest, StreamReg32 &src1, StreamReg32 &src2) { baseBehaviour(dest, src1, src2, predReg, int{}, (long int){}); },
+               [&](auto &dest, auto &src1, auto &src2) { assert_msg("Invoking so.a.mac.w.sg with invalid parameter sizes", false); }},
+           P.SU.registers[streamReg], P.SU.registers[insn.uve_rs1()], P.SU.registers[insn.uve_rs2()]);
@@ -1,6 +1,6 @@
 auto regN = insn.uve_branch_rs();
 auto branchIMM = insn.uve_branch_imm();
 
-if (!P.SU.EODTable.at(regN).at(1)){
+if (!P.SU.isEndOfDimension(regN, 1)){
     set_pc(pc + branchIMM);
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 auto regN = insn.uve_branch_rs();
 auto branchIMM = insn.uve_branch_imm();
 
-if (!P.SU.EODTable.at(regN).at(2))
+if (!P.SU.isEndOfDimension(regN, 2))
     set_pc(pc + branchIMM);
\ No newline at end of file
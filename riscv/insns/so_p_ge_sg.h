@@ -1,7 +1,5 @@
 auto dest = insn.uve_pred_rd();
 auto& destPReg = P.SU.predicates[dest];
-auto& src1Reg = P.SU.registers[insn.uve_pred_vs1()];
-auto& src2Reg = P.SU.registers[insn.uve_pred_rs2()];
 auto& predReg = P.SU.predicates[insn.uve_pred()];
 
 auto baseBehaviour = [](auto &destP, auto &src1, auto &src2, auto &pred, auto extra) {
@@ -11,36 +9,28 @@ auto baseBehaviour = [](auto &destP, auto &src1, auto &src2, auto &pred, auto ex
     /* We can only operate on the first available values of the stream */
     auto elements1 = src1.getElements();
     auto elements2 = src2.getElements();
-    auto destElements = destP.getPredicate();
     auto validElementsIndex = std::min(src1.getValidElements(), src2.getValidElements());
 
-    auto pi = pred.getPredicate();
-    std::vector<uint8_t> predicate(pred.vLen);
+    /* Grab used types for storage and operation */
+    using OperationType = decltype(extra);
+    constexpr size_t width = sizeof(OperationType);
 
-    auto iterator = predicate.begin();
-
-    if (validElementsIndex) {
-        /* Grab used types for storage and operation */
-        using OperationType = decltype(extra);
-        uint8_t value = 0;
-        for (size_t i = 0; i < validElementsIndex; i++) {
-            if(pi.at((i+1)*sizeof(OperationType)-1)){
-                OperationType e1 = readAS<OperationType>(elements1.at(i));
-                OperationType e2 = readAS<OperationType>(elements2.at(i));
-                value = e1 >= e2;
-            } else
-                value = readAS<OperationType>(destElements.at(i));
-            std::fill(iterator, iterator+sizeof(OperationType), value);
-            iterator += sizeof(OperationType);
-        }
+    /* Each result is flagged at the last byte of its element */
+    predRegister_t::MaskType value = 0;
+    for (size_t i = 0; i < validElementsIndex; i++) {
+        OperationType e1 = readAS<OperationType>(elements1[i]);
+        OperationType e2 = readAS<OperationType>(elements2[i]);
+        value |= predRegister_t::MaskType(e1 >= e2) << ((i + 1) * width - 1);
     }
-    return predicate;
+
+    /* Inactive elements keep the destination flags; elements past the valid ones are cleared */
+    value = predRegister_t::merge(predRegister_t::fillElements(value, width), destP.getPredicate(), pred.getPredicate(), width);
+    return value & predRegister_t::firstElements(validElementsIndex, width);
 };
 
-std::visit(overloaded{
+P.SU.dispatchByWidth(overloaded{
     [&](StreamReg8 &src1, StreamReg8 &src2) { auto pr = baseBehaviour(destPReg, src1, src2, predReg, (signed char){}); P.SU.makePredRegister(pr, dest); },
     [&](StreamReg16 &src1, StreamReg16 &src2) { auto pr = baseBehaviour(destPReg, src1, src2, predReg, (short int){}); P.SU.makePredRegister(pr, dest); },
     [&](StreamReg32 &src1, StreamReg32 &src2) { auto pr = baseBehaviour(destPReg, src1, src2, predReg, int{}); P.SU.makePredRegister(pr, dest); },
-    [&](StreamReg64 &src1, StreamReg64 &src2) { auto pr = baseBehaviour(destPReg, src1, src2, predReg, (long int){}); P.SU.makePredRegister(pr, dest); },
-    [&](auto &src1, auto &src2) { assert_msg("Invoking so.p.egt.sg with invalid parameter sizes", false); }
-}, src1Reg, src2Reg);
\ No newline at end of file
+    [&](StreamReg64 &src1, StreamReg64 &src2) { auto pr = baseBehaviour(destPReg, src1, src2, predReg, (long int){}); P.SU.makePredRegister(pr, dest); }
+}, insn.uve_pred_vs1(), insn.uve_pred_rs2());
\ No newline at end of file
@@ -5,14 +5,6 @@ auto &predReg = P.SU.predicates[insn.uve_pred()];
 
 auto pi = predReg.getPredicate(); // instruction predicate
 
-auto predicate = srcPReg.getPredicate();
-size_t size = srcPReg.vLen;
-
-auto destPredicate = destPReg.getPredicate();
-
-for (size_t i = 0; i < size; ++i) {
-    if (!pi.at(i))
-        predicate.at(i) = destPredicate.at(i);
-}
+auto predicate = predRegister_t::merge(srcPReg.getPredicate(), destPReg.getPredicate(), pi);
 
 P.SU.makePredRegister(predicate, dest);
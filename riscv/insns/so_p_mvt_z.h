@@ -3,18 +3,10 @@ auto &destPReg = P.SU.predicates[dest];
 auto &srcPReg = P.SU.predicates[insn.uve_pred_rs1()];
 auto &predReg = P.SU.predicates[insn.uve_pred()];
 
-auto pi = predReg.getPredicate();
-std::reverse(pi.begin(), pi.end()); // reverse the instruction predicate
+auto pi = predRegister_t::reverse(predReg.getPredicate(), P.SU.getRegisterLength()); // reverse the instruction predicate
 
-auto predicate = srcPReg.getPredicate();
-std::reverse(predicate.begin(), predicate.end()); // reverse the source predicate
-size_t size = srcPReg.vLen;
+auto predicate = predRegister_t::reverse(srcPReg.getPredicate(), P.SU.getRegisterLength()); // reverse the source predicate
 
-auto destPredicate = destPReg.getPredicate();
-
-for (size_t i = 0; i < size; ++i) {
-    if (!pi.at(i))
-        predicate.at(i) = destPredicate.at(i);
-}
+predicate = predRegister_t::merge(predicate, destPReg.getPredicate(), pi);
 
 P.SU.makePredRegister(predicate, dest);
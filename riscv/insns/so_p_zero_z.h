@@ -3,13 +3,7 @@ auto& destPReg = P.SU.predicates[dest];
 auto &predReg = P.SU.predicates[insn.uve_pred()];
 
 auto pi = predReg.getPredicate();
-auto destElements = destPReg.getPredicate();
 
-std::vector<uint8_t> predicate(destPReg.vLen, 0);
-
-for (size_t i = 0; i < destPReg.vLen; i++){
-    if (!pi.at(i))
-        predicate.at(i) = destElements.at(i); // merging
-}
+auto predicate = predRegister_t::merge(predRegister_t::MaskType(0), destPReg.getPredicate(), pi); // merging
 
 P.SU.makePredRegister(predicate, dest);
@@ -0,0 +1,54 @@
+auto streamReg = insn.uve_rd();
+auto &destReg = P.SU.registers[streamReg];
+auto &srcReg = P.SU.registers[insn.uve_rs1()];
+
+/* destExtra is the computation type of the 16-bit elements produced */
+auto baseBehaviour = [](auto &dest, auto &src, auto extra, auto destExtra) {
+    using StorageType = uint16_t;
+    using OperationType = decltype(extra);
+    using DestOperationType = decltype(destExtra);
+    size_t destVLen = dest.getVLen();
+
+    auto elements = src.getElements(!src.getValidElements());
+
+    auto srcValidElements = src.getValidElements();
+
+    size_t finalElementCount = std::min(destVLen, srcValidElements);
+
+    typename std::remove_reference_t<decltype(dest)>::ElementsStorage out{};
+
+    for (size_t i = 0; i < finalElementCount; ++i)
+        out.at(i) = readAS<StorageType>(DestOperationType(static_cast<double>(readAS<OperationType>(elements.at(i)))));
+
+    if (finalElementCount < srcValidElements) {
+        src.setValidIndex(srcValidElements - finalElementCount);
+        // set src elements to the remaining elements (from finalElementCount to srcValidElements)
+       decltype(elements) newElements{};
+        for (size_t i = 0; i < srcValidElements - finalElementCount; ++i)
+            newElements.at(i) = elements.at(i + finalElementCount);
+        src.setElements(newElements);
+    } else
+        src.setValidIndex(0);
+
+    dest.setValidIndex(finalElementCount);
+    dest.setElements(out);
+};
+
+/* If the destination register is not configured, we have to build it before the
+operation so that its element size matches before any calculations are done */
+std::visit([&](auto &dest) {
+    if (dest.getStatus() == RegisterStatus::NotConfigured) {
+        P.SU.makeStreamRegister<std::uint16_t>(streamReg);
+        dest.endConfiguration();
+    }
+},
+           destReg);
+
+withFp16Type(P.SU, [&](auto half) {
+    std::visit(overloaded{
+                   [&](StreamReg16 &dest, StreamReg16 &src) { baseBehaviour(dest, src, half, half); },
+                   [&](StreamReg16 &dest, StreamReg32 &src) { baseBehaviour(dest, src, float{}, half); },
+                   [&](StreamReg16 &dest, StreamReg64 &src) { baseBehaviour(dest, src, double{}, half); },
+                   [&](auto &dest, auto &src) { assert_msg("Invoking so.v.cv.fp.h with invalid parameter sizes", false); }},
+               destReg, srcReg);
+});
\ No newline at end of file
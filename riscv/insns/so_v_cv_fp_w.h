@@ -14,7 +14,7 @@ auto baseBehaviour = [](auto &dest, auto &src, auto extra) {
 
     size_t finalElementCount = std::min(destVLen, srcValidElements);
 
-    std::vector<StorageType> out(destVLen, 0);
+    typename std::remove_reference_t<decltype(dest)>::ElementsStorage out{};
 
     for (size_t i = 0; i < finalElementCount; ++i)
         out.at(i) = readAS<StorageType>(static_cast<float>(readAS<OperationType>(elements.at(i))));
@@ -22,7 +22,7 @@ auto baseBehaviour = [](auto &dest, auto &src, auto extra) {
     if (finalElementCount < srcValidElements) {
         src.setValidIndex(srcValidElements - finalElementCount);
         // set src elements to the remaining elements (from finalElementCount to srcValidElements)
-       decltype(elements) newElements(srcVLen, 0);
+       decltype(elements) newElements{};
         for (size_t i = 0; i < srcValidElements - finalElementCount; ++i)
             newElements.at(i) = elements.at(i + finalElementCount);
         src.setElements(newElements);
@@ -44,6 +44,7 @@ std::visit([&](auto &dest) {
            destReg);
 
 std::visit(overloaded{
+               [&](StreamReg32 &dest, StreamReg16 &src) { withFp16Type(P.SU, [&](auto extra) { baseBehaviour(dest, src, extra); }); },
                [&](StreamReg32 &dest, StreamReg32 &src) { baseBehaviour(dest, src, float{}); },
                [&](StreamReg32 &dest, StreamReg64 &src) { baseBehaviour(dest, src, double{}); },
                [&](auto &dest, auto &src) { assert_msg("Invoking so.v.cv.fp.w with invalid parameter sizes", false); }},
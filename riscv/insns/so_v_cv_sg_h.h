@@ -15,7 +15,7 @@ auto baseBehaviour = [](auto &dest, auto &src, auto extra) {
 
     size_t finalElementCount = std::min(destVLen, srcValidElements);
 
-    std::vector<StorageType> out(destVLen, 0);
+    typename std::remove_reference_t<decltype(dest)>::ElementsStorage out{};
 
     for (size_t i = 0; i < finalElementCount; ++i)
         out.at(i) = readAS<StorageType>(static_cast<short int>(readAS<OperationType>(elements.at(i))));
@@ -23,7 +23,7 @@ auto baseBehaviour = [](auto &dest, auto &src, auto extra) {
     if (finalElementCount < srcValidElements) {
         src.setValidIndex(srcValidElements-finalElementCount);
         // set src elements to the remaining elements (from finalElementCount to srcValidElements)
-       decltype(elements) newElements(srcVLen, 0);
+       decltype(elements) newElements{};
         for (size_t i = 0; i < srcValidElements - finalElementCount; ++i)
             newElements.at(i) = elements.at(i + finalElementCount);
         src.setElements(newElements);
@@ -8,13 +8,12 @@ auto &predReg = P.SU.predicates[insn.uve_v_pred()];
 const uint64_t value = readRegAS(uint64_t, baseReg);
 
 auto baseBehaviour = [](auto &dest, auto &pred, const auto value) {
-    auto pi = pred.getPredicate();
     auto destElements = dest.getElements(false);
     auto destValidIndex = dest.getVLen();
-    std::vector<uint64_t> out(destValidIndex);
+    typename std::remove_reference_t<decltype(dest)>::ElementsStorage out{};
 
     for (size_t i = 0; i < destValidIndex; ++i)
-        out.at(i) = pi.at((i+1)*sizeof(uint64_t)-1) ? value : destElements.at(i);
+        out.at(i) = pred.isElementActive(i, sizeof(uint64_t)) ? value : destElements.at(i);
 
     dest.setMode(RegisterMode::Vector);
     dest.setElements(out);
@@ -31,7 +30,6 @@ std::visit([&](auto &dest) {
     }
 }, destReg);
 
-std::visit(overloaded {
-    [&, value](StreamReg64& dest) { baseBehaviour(dest, predReg, value); },
-    [&, value](auto& dest) { assert_msg("Invoking so.v.dp.d with invalid parameter sizes", false); }
-}, destReg);
\ No newline at end of file
+P.SU.dispatchByWidth(overloaded{
+    [&, value](StreamReg64& dest) { baseBehaviour(dest, predReg, value); }
+}, streamReg);
\ No newline at end of file
@@ -8,7 +8,7 @@ const uint8_t value = readRegAS(uint8_t, baseReg);
 
 
 auto baseBehaviour = [](auto &dest, auto value) {
-    std::vector<uint8_t> out(dest.getVLen());
+    typename std::remove_reference_t<decltype(dest)>::ElementsStorage out{};
 
     out.at(0) = value;
 
@@ -25,7 +25,5 @@ std::visit([&](auto &dest) {
     }
 }, destReg);
 
-std::visit(overloaded{
-    [&](StreamReg8 &dest) { baseBehaviour(dest, value); },
-    [&](auto &dest) { assert_msg("Invoking so.v.mvsv.b with invalid parameter sizes", false); }},
-destReg);
\ No newline at end of file
+P.SU.dispatchByWidth(overloaded{
+    [&](StreamReg8 &dest) { baseBehaviour(dest, value); }}, streamReg);
\ No newline at end of file
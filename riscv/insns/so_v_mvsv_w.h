@@ -8,7 +8,7 @@ const uint32_t value = readRegAS(uint32_t, baseReg);
 
 
 auto baseBehaviour = [](auto &dest, auto value) {
-    std::vector<uint32_t> out(dest.getVLen());
+    typename std::remove_reference_t<decltype(dest)>::ElementsStorage out{};
 
     out.at(0) = value;
 
@@ -25,7 +25,5 @@ std::visit([&](auto &dest) {
     }
 }, destReg);
 
-std::visit(overloaded{
-    [&](StreamReg32 &dest) { baseBehaviour(dest, value); },
-    [&](auto &dest) { assert_msg("Invoking so.v.mvsv.w with invalid parameter sizes", false); }},
-destReg);
\ No newline at end of file
+P.SU.dispatchByWidth(overloaded{
+    [&](StreamReg32 &dest) { baseBehaviour(dest, value); }}, streamReg);
\ No newline at end of file
@@ -14,14 +14,13 @@ auto baseBehaviour = [](auto &dest, auto &src, auto &pred) {
 
     auto destElements = dest.getElements(false); // doesn't iterate the stream
 
-    std::vector<StorageType> out(dest.getVLen());
+    typename std::remove_reference_t<decltype(dest)>::ElementsStorage out{};
 
-    auto pi = pred.getPredicate();
-    std::reverse(pi.begin(), pi.begin() + validElementsIndex * sizeof(StorageType)); // reverse the necessary instruction predicate
+    auto pi = predRegister_t::reverse(pred.getPredicate(), validElementsIndex * sizeof(StorageType)); // reverse the necessary instruction predicate
 
     for (size_t i = 0; i < vLen; ++i) {
         if (i < validElementsIndex)
-            out.at(i) = pi.at((i + 1) * sizeof(StorageType) - 1) ? elements.at(i) : destElements.at(i);
+            out.at(i) = predRegister_t::isElementActive(pi, i, sizeof(StorageType)) ? elements.at(i) : destElements.at(i);
         else if (zeroing)
             out.at(i) = 0;
     }
@@ -53,10 +52,8 @@ std::visit([&](auto &dest) {
 },
            destReg);
 
-std::visit(overloaded{
+P.SU.dispatchByWidth(overloaded{
                [&](StreamReg64 &dest, StreamReg64 &src) { baseBehaviour(dest, src, predReg); },
                [&](StreamReg32 &dest, StreamReg32 &src) { baseBehaviour(dest, src, predReg); },
                [&](StreamReg16 &dest, StreamReg16 &src) { baseBehaviour(dest, src, predReg); },
-               [&](StreamReg8 &dest, StreamReg8 &src) { baseBehaviour(dest, src, predReg); },
-               [&](auto &dest, auto &src) { assert_msg("Invoking so.v.mvt with invalid parameter sizes", false); }},
-           destReg, srcReg);
\ No newline at end of file
+               [&](StreamReg8 &dest, StreamReg8 &src) { baseBehaviour(dest, src, predReg); }}, streamReg, insn.uve_rs1());
\ No newline at end of file
@@ -4,6 +4,7 @@
 #define _MEMTRACER_H
 
 #include <cstdint>
+#include <memory>
 #include <string.h>
 #include <vector>
 
@@ -13,6 +14,25 @@ enum access_type {
   FETCH,
 };
 
+// A run of equally sized accesses to consecutive physical addresses
+struct memtrace_range_t {
+  uint64_t addr;
+  size_t bytes;
+  size_t access_bytes;
+};
+
+// Addresses a UVE stream is going to access, known from its descriptor
+// when the stream is configured
+class stream_pattern_t
+{
+ public:
+  virtual ~stream_pattern_t() {}
+  virtual std::unique_ptr<stream_pattern_t> clone() const = 0;
+  // Physical address of the next element, or false if it is not known yet
+  // or the stream has ended
+  virtual bool next(uint64_t& paddr) = 0;
+};
+
 class memtracer_t
 {
  public:
@@ -22,6 +42,20 @@ class memtracer_t
   virtual bool interested_in_range(uint64_t begin, uint64_t end, access_type type) = 0;
   virtual void trace(uint64_t addr, size_t bytes, access_type type) = 0;
   virtual void clean_invalidate(uint64_t addr, size_t bytes, bool clean, bool inval) = 0;
+
+  // Accesses made by one register fill of the UVE stream held in stream
+  // register `stream`. Tracers that do not tell streams apart see them as
+  // individual accesses.
+  virtual void trace_stream(size_t, const std::vector<memtrace_range_t>& ranges, access_type type)
+  {
+    for (auto& r : ranges)
+      for (size_t offset = 0; offset < r.bytes; offset += r.access_bytes)
+        trace(r.addr + offset, r.access_bytes, type);
+  }
+
+  // The UVE stream held in stream register `stream` was configured, with the
+  // given pattern, or none if its addresses depend on other streams
+  virtual void stream_configured(size_t, const stream_pattern_t*) {}
 };
 
 class memtracer_list_t : public memtracer_t
@@ -45,6 +79,16 @@ class memtracer_list_t : public memtracer_t
     for (auto it: list)
       it->clean_invalidate(addr, bytes, clean, inval);
   }
+  void trace_stream(size_t stream, const std::vector<memtrace_range_t>& ranges, access_type type)
+  {
+    for (auto it: list)
+      it->trace_stream(stream, ranges, type);
+  }
+  void stream_configured(size_t stream, const stream_pattern_t* pattern)
+  {
+    for (auto it: list)
+      it->stream_configured(stream, pattern);
+  }
   void hook(memtracer_t* h)
   {
     list.push_back(h);
@@ -232,6 +232,23 @@ void mmu_t::check_triggers(triggers::operation_t operation, reg_t address, bool
     }
 }
 
+inline void mmu_t::trace(reg_t paddr, reg_t len, access_type type)
+{
+  if (!trace_capture) {
+    tracer.trace(paddr, len, type);
+    return;
+  }
+
+  if (!trace_capture->empty()) {
+    auto& last = trace_capture->back();
+    if (last.addr + last.bytes == paddr && last.access_bytes == len) {
+      last.bytes += len;
+      return;
+    }
+  }
+  trace_capture->push_back({paddr, len, len});
+}
+
 inline void mmu_t::perform_intrapage_load(reg_t vaddr, uintptr_t host_addr, reg_t paddr, reg_t len, uint8_t* bytes, xlate_flags_t xlate_flags)
 {
   if (host_addr) {
@@ -245,7 +262,7 @@ inline void mmu_t::perform_intrapage_load(reg_t vaddr, uintptr_t host_addr, reg_
   }
 
   if (tracer.interested_in_range(paddr, paddr + len, LOAD))
-    tracer.trace(paddr, len, LOAD);
+    trace(paddr, len, LOAD);
 }
 
 void mmu_t::load_slow_path_intrapage(reg_t len, uint8_t* bytes, mem_access_info_t access_info)
@@ -332,7 +349,7 @@ inline void mmu_t::perform_intrapage_store(reg_t vaddr, uintptr_t host_addr, reg
   }
 
   if (tracer.interested_in_range(paddr, paddr + len, STORE))
-    tracer.trace(paddr, len, STORE);
+    trace(paddr, len, STORE);
 }
 
 void mmu_t::store_slow_path_intrapage(reg_t len, const uint8_t* bytes, mem_access_info_t access_info, bool actually_store)
@@ -115,6 +115,27 @@ public:
     return from_target(res);
   }
 
+  // Host address of [addr, addr + len) for a bulk load, or 0 if the caller
+  // must fall back to per-element loads. The range must sit in a single page
+  // whose TLB entry hits without trigger, tracer or MMIO flags, which is the
+  // same condition load() uses for its own fast path.
+  uintptr_t ALWAYS_INLINE load_host_range(reg_t addr, reg_t len) {
+    if (target_big_endian != is_be() || (addr % PGSIZE) + len > PGSIZE)
+      return 0;
+    auto [tlb_hit, host_addr, _] = access_tlb(tlb_load, addr);
+    return tlb_hit ? host_addr : 0;
+  }
+
+  // Store counterpart of load_host_range. A store TLB hit implies the page has
+  // already gone through store_slow_path_intrapage, so the instruction TLB
+  // exclusion and reverse tags required by Ziccid are in place.
+  uintptr_t ALWAYS_INLINE store_host_range(reg_t addr, reg_t len) {
+    if (target_big_endian != is_be() || (addr % PGSIZE) + len > PGSIZE)
+      return 0;
+    auto [tlb_hit, host_addr, _] = access_tlb(tlb_store, addr);
+    return tlb_hit ? host_addr : 0;
+  }
+
   template<typename T>
   T load_reserved(reg_t addr) {
     return load<T>(addr, {.lr = true});
@@ -371,6 +392,46 @@ public:
 
   void register_memtracer(memtracer_t*);
 
+  // While capturing, traced accesses are collected into ranges instead of
+  // being reported one at a time, so that the streaming unit can hand the
+  // accesses of a stream register fill to the tracers as one batch. Returns
+  // the previous capture, for fills nested in another one.
+  std::vector<memtrace_range_t>* capture_traces(std::vector<memtrace_range_t>* ranges)
+  {
+    return std::exchange(trace_capture, ranges);
+  }
+
+  void trace_stream(size_t stream, const std::vector<memtrace_range_t>& ranges, access_type type)
+  {
+    if (!ranges.empty())
+      tracer.trace_stream(stream, ranges, type);
+  }
+
+  bool has_memtracers()
+  {
+    return !tracer.empty();
+  }
+
+  void stream_configured(size_t stream, const stream_pattern_t* pattern)
+  {
+    tracer.stream_configured(stream, pattern);
+  }
+
+  // Physical address of addr if its page is in the load or store TLB,
+  // without walking the page tables or raising exceptions. Prefetch models
+  // use it to follow virtual address streams.
+  bool probe_tlb(reg_t addr, reg_t& paddr)
+  {
+    for (auto tlb : {tlb_load, tlb_store}) {
+      auto [hit, _, target_addr] = access_tlb(tlb, addr, TLB_FLAGS);
+      if (hit) {
+        paddr = target_addr;
+        return true;
+      }
+    }
+    return false;
+  }
+
   int is_misaligned_enabled()
   {
     return proc && proc->get_cfg().misaligned;
@@ -395,6 +456,7 @@ private:
   simif_t* sim;
   processor_t* proc;
   memtracer_list_t tracer;
+  std::vector<memtrace_range_t>* trace_capture = nullptr;
   reg_t load_reservation_address;
   reg_t blocksz;
 
@@ -440,6 +502,7 @@ private:
   insn_parcel_t perform_intrapage_fetch(reg_t vaddr, uintptr_t host_addr, reg_t paddr);
   void load_slow_path(reg_t original_addr, reg_t len, uint8_t* bytes, xlate_flags_t xlate_flags);
   void load_slow_path_intrapage(reg_t len, uint8_t* bytes, mem_access_info_t access_info);
+  void trace(reg_t paddr, reg_t len, access_type type);
   void perform_intrapage_load(reg_t vaddr, uintptr_t host_addr, reg_t paddr, reg_t len, uint8_t* bytes, xlate_flags_t xlate_flags);
   void store_slow_path(reg_t original_addr, reg_t len, const uint8_t* bytes, xlate_flags_t xlate_flags, bool actually_store, bool require_alignment);
   void store_slow_path_intrapage(reg_t len, const uint8_t* bytes, mem_access_info_t access_info, bool actually_store);
@@ -44,6 +44,11 @@ processor_t::processor_t(const char* isa_str, const char* priv_str,
 {
   VU.p = this;
   SU.p = this; // UVE
+  SU.setRegisterLength(cfg->uve_vlen);
+  SU.setFp16Format(cfg->uve_bf16 ? Fp16Format::BFloat16 : Fp16Format::Half);
+  SU.setFp8Format(cfg->uve_e5m2 ? Fp8Format::E5M2 : Fp8Format::E4M3);
+  if (cfg->uve_timing)
+    SU.enableTiming(cfg->uve_timing->fifo_depth, cfg->uve_timing->bandwidth, cfg->uve_timing->latency);
   TM.proc = this;
 
 #ifndef HAVE_INT128
@@ -119,6 +124,7 @@ void state_t::reset(processor_t* const proc, reg_t max_isa)
   log_reg_write.clear();
   log_mem_read.clear();
   log_mem_write.clear();
+  log_stream_mem.clear();
   last_inst_priv = 0;
   last_inst_xlen = 0;
   last_inst_flen = 0;
@@ -155,6 +161,7 @@ void processor_t::reset()
   state.reset(this, isa.get_max_isa());
   if (any_vector_extensions())
     VU.reset();
+  SU.reset();
   in_wfi = false;
 
   if (n_pmp > 0) {
@@ -18,6 +18,7 @@
 #include "../fesvr/memif.h"
 #include "vector_unit.h"
 #include "streaming_unit.h" // UVE Implementation
+#include "streaming_kernels.h"
 #include <utility> //uve
 #include <variant> // uve
 
@@ -70,6 +71,17 @@ typedef std::map<reg_t, freg_t> commit_log_reg_t;
 // addr, value, size
 typedef std::vector<std::tuple<reg_t, uint64_t, uint8_t>> commit_log_mem_t;
 
+// UVE stream accesses of a register fill, as runs of equally spaced elements
+struct commit_log_stream_run_t {
+  reg_t addr;
+  int64_t stride;
+  uint64_t count;
+  uint8_t size;
+  uint8_t stream;
+  bool store;
+};
+typedef std::vector<commit_log_stream_run_t> commit_log_stream_mem_t;
+
 // architectural state of a RISC-V hart
 struct state_t
 {
@@ -198,6 +210,7 @@ struct state_t
   commit_log_reg_t log_reg_write;
   commit_log_mem_t log_mem_read;
   commit_log_mem_t log_mem_write;
+  commit_log_stream_mem_t log_stream_mem;
   reg_t last_inst_priv;
   int last_inst_xlen;
   int last_inst_flen;
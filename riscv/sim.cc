@@ -13,6 +13,7 @@
 #include <map>
 #include <iostream>
 #include <sstream>
+#include <cinttypes>
 #include <climits>
 #include <cstdlib>
 #include <cassert>
@@ -268,11 +269,32 @@ sim_t::sim_t(const cfg_t *cfg, bool halted,
 
 sim_t::~sim_t()
 {
+  if (cfg->uve_stats_file)
+    dump_uve_stats(cfg->uve_stats_file);
+
   for (size_t i = 0; i < procs.size(); i++)
     delete procs[i];
   delete debug_mmu;
 }
 
+void sim_t::dump_uve_stats(const char* path) const
+{
+  FILE* out = fopen(path, "w");
+  if (!out) {
+    fprintf(stderr, "Unable to open UVE stats file '%s'\n", path);
+    return;
+  }
+
+  fprintf(out, "{\"harts\": [");
+  for (size_t i = 0; i < procs.size(); i++) {
+    fprintf(out, "%s\n  {\"hartid\": %" PRIu32 ", \"uve\": ", i ? "," : "", procs[i]->get_id());
+    procs[i]->SU.dumpStats(out);
+    fprintf(out, "}");
+  }
+  fprintf(out, "\n]}\n");
+  fclose(out);
+}
+
 int sim_t::run()
 {
   if (!debug && log)
@@ -93,6 +93,7 @@ private:
   std::ostream sout_; // used for socket and terminal interface
 
   processor_t* get_core(const std::string& i);
+  void dump_uve_stats(const char* path) const;
   void step(size_t n); // step through simulation
   size_t current_step;
   size_t current_proc;
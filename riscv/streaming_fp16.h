@@ -0,0 +1,150 @@
+#ifndef STREAMING_FP16_HPP
+#define STREAMING_FP16_HPP
+
+#include "helpers.h"
+#include "softfloat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/* --- 16-bit floating-point computation types --- */
+
+/* Elements of 16-bit streams operated on as IEEE half precision or bfloat16
+numbers. They mirror the 32- and 64-bit computation types (float and double)
+closely enough for the so.a.* instructions to use them unchanged: they are
+built from any arithmetic value, compare with them, and only convert back to
+float or double explicitly.
+
+The host has no arithmetic for either format, but single precision has more
+than twice their precision plus two bits, so an operation done on floats and
+rounded once more to 16 bits gives the correctly rounded result. Widening and
+rounding are done with host float operations too, as softfloat calls cost more
+than the arithmetic itself. Conversions from double are left to softfloat */
+
+struct halfFormat_t {
+    /* Normal values are rebiased by a multiplication, subnormal ones by
+    subtracting the implicit bit of a float holding them in its mantissa */
+    static float toFloat(std::uint16_t a) {
+        const std::uint32_t twice = std::uint32_t(a) << 17, sign = std::uint32_t(a & 0x8000) << 16;
+        const float normal = readAS<float>((twice >> 4) + (0xe0u << 23)) * 0x1.0p-112f;
+        const float subnormal = readAS<float>((twice >> 17) | (126u << 23)) - 0.5f;
+        return readAS<float>(sign | readAS<std::uint32_t>(twice < (1u << 27) ? subnormal : normal));
+    }
+
+    /* Adding a power of two chosen from the exponent makes the host round the
+    mantissa to the bits half precision keeps, subnormals included. Scaling by
+    2^112 and back first turns values out of range into infinities */
+    static std::uint16_t fromFloat(float a) {
+        const std::uint32_t w = readAS<std::uint32_t>(a), twice = w + w;
+        const std::uint32_t bias = std::max(twice & 0xff000000, 0x71000000u);
+        const float rounded = readAS<float>((bias >> 1) + 0x07800000) + std::fabs(a) * 0x1.0p+112f * 0x1.0p-110f;
+        const std::uint32_t bits = readAS<std::uint32_t>(rounded);
+        const std::uint16_t magnitude = twice > 0xff000000 ? 0x7e00 : ((bits >> 13) & 0x7c00) + (bits & 0x0fff);
+        return std::uint16_t(w >> 16 & 0x8000) | magnitude;
+    }
+
+    static std::uint16_t fromDouble(double a) { return f64_to_f16(float64_t{readAS<std::uint64_t>(a)}).v; }
+
+    static constexpr std::uint16_t minNormal = 0x0400;
+    static constexpr std::uint16_t maxFinite = 0x7bff;
+    static constexpr std::uint16_t infinity = 0x7c00;
+};
+
+/* bfloat16 is the upper half of a float: it widens by a shift, and rounds to
+nearest even by adding just under half of the bits it drops */
+struct bfloatFormat_t {
+    static float toFloat(std::uint16_t a) { return readAS<float>(std::uint32_t(a) << 16); }
+
+    static std::uint16_t fromFloat(float a) {
+        const std::uint32_t w = readAS<std::uint32_t>(a);
+        if ((w & 0x7fffffff) > 0x7f800000)
+            return 0x7fc0;
+        return std::uint16_t((w + 0x7fff + (w >> 16 & 1)) >> 16);
+    }
+
+    static std::uint16_t fromDouble(double a) { return f64_to_bf16(float64_t{readAS<std::uint64_t>(a)}).v; }
+
+    static constexpr std::uint16_t minNormal = 0x0080;
+    static constexpr std::uint16_t maxFinite = 0x7f7f;
+    static constexpr std::uint16_t infinity = 0x7f80;
+};
+
+template <typename Format>
+struct fp16_t {
+    std::uint16_t bits;
+
+    fp16_t() = default;
+    fp16_t(double value) : bits(Format::fromDouble(value)) {}
+
+    static constexpr fp16_t fromBits(std::uint16_t b) {
+        fp16_t r;
+        r.bits = b;
+        return r;
+    }
+
+    explicit operator float() const { return Format::toFloat(bits); }
+    explicit operator double() const { return Format::toFloat(bits); }
+
+    fp16_t operator-() const { return fromBits(bits ^ 0x8000); }
+
+    friend fp16_t operator+(fp16_t a, fp16_t b) { return round(float(a) + float(b)); }
+    friend fp16_t operator-(fp16_t a, fp16_t b) { return round(float(a) - float(b)); }
+    friend fp16_t operator*(fp16_t a, fp16_t b) { return round(float(a) * float(b)); }
+    friend fp16_t operator/(fp16_t a, fp16_t b) { return round(float(a) / float(b)); }
+
+    fp16_t &operator+=(fp16_t b) { return *this = *this + b; }
+    fp16_t &operator-=(fp16_t b) { return *this = *this - b; }
+    fp16_t &operator*=(fp16_t b) { return *this = *this * b; }
+    fp16_t &operator/=(fp16_t b) { return *this = *this / b; }
+
+    /* Widening is exact, so comparisons are the ones of float */
+    friend bool operator==(fp16_t a, fp16_t b) { return float(a) == float(b); }
+    friend bool operator!=(fp16_t a, fp16_t b) { return float(a) != float(b); }
+    friend bool operator<(fp16_t a, fp16_t b) { return float(a) < float(b); }
+    friend bool operator<=(fp16_t a, fp16_t b) { return float(a) <= float(b); }
+    friend bool operator>(fp16_t a, fp16_t b) { return float(a) > float(b); }
+    friend bool operator>=(fp16_t a, fp16_t b) { return float(a) >= float(b); }
+
+    /* Found by argument-dependent lookup, next to the ones of float and double */
+    friend fp16_t sqrt(fp16_t a) { return round(std::sqrt(float(a))); }
+    friend fp16_t abs(fp16_t a) { return fromBits(a.bits & 0x7fff); }
+
+private:
+    static fp16_t round(float value) { return fromBits(Format::fromFloat(value)); }
+};
+
+using half_t = fp16_t<halfFormat_t>;
+using bfloat_t = fp16_t<bfloatFormat_t>;
+
+template <typename Format>
+struct std::numeric_limits<fp16_t<Format>> {
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool has_infinity = true;
+    static constexpr fp16_t<Format> min() { return fp16_t<Format>::fromBits(Format::minNormal); }
+    static constexpr fp16_t<Format> max() { return fp16_t<Format>::fromBits(Format::maxFinite); }
+    static constexpr fp16_t<Format> lowest() { return fp16_t<Format>::fromBits(Format::maxFinite | 0x8000); }
+    static constexpr fp16_t<Format> infinity() { return fp16_t<Format>::fromBits(Format::infinity); }
+};
+
+/* Softfloat rounding mode and exception flags for the 16-bit operations of an
+instruction. Like the 32- and 64-bit ones, done in host floating point, they
+round to nearest even and leave no exception flags behind */
+struct fp16Scope_t {
+    fp16Scope_t() : roundingMode(softfloat_roundingMode), exceptionFlags(softfloat_exceptionFlags) {
+        softfloat_roundingMode = softfloat_round_near_even;
+    }
+
+    ~fp16Scope_t() {
+        softfloat_roundingMode = roundingMode;
+        softfloat_exceptionFlags = exceptionFlags;
+    }
+
+private:
+    uint_fast8_t roundingMode;
+    uint_fast8_t exceptionFlags;
+};
+
+#endif // STREAMING_FP16_HPP
@@ -0,0 +1,241 @@
+#ifndef STREAMING_KERNELS_HPP
+#define STREAMING_KERNELS_HPP
+
+#include "streaming_fp16.h"
+#include "streaming_unit.h"
+#include "bulknormdot.h"
+#include <algorithm>
+#include <bit>
+#include <tuple>
+#include <utility>
+
+/* --- Arithmetic kernels shared by the so.a.* instructions --- */
+
+/* What happens to the elements between the last valid one and the vector
+length of the operation */
+enum class TailPolicy { ZeroIfZeroing, // cleared if every source is in zeroing mode
+                        AlwaysZero };
+
+/* Mode the destination is left in */
+enum class ResultMode { FollowSources, // scalar if any source is scalar
+                        Vector };
+
+/* Whether the operation may be evaluated on every lane and then blended into
+the destination, which lets the compiler vectorise it. Operations that can trap
+or are undefined for some operands (integer division, shifts) are only ever
+evaluated on the active lanes */
+enum class LaneEvaluation { AllLanes,
+                            ActiveOnly };
+
+/* Results as wide as the storage are kept bit for bit, others (integer
+promotions, mostly) are first converted back to the operation type */
+template <typename StorageType, typename OperationType, typename Result>
+StorageType toStorage(Result result) {
+    if constexpr (sizeof(Result) == sizeof(StorageType))
+        return readAS<StorageType>(result);
+    else
+        return readAS<StorageType>(OperationType(result));
+}
+
+/* streamElementwise for registers of N elements */
+template <size_t N, typename OperationType, LaneEvaluation Evaluation, typename Dest, typename Op, typename... Srcs>
+void streamElementwiseOf(Dest &dest, const predRegister_t &pred, const TailPolicy tail, const ResultMode mode, Op &op, Srcs &...srcs) {
+    using StorageType = typename Dest::ElementsType;
+    constexpr size_t width = sizeof(StorageType);
+    static_assert(sizeof(OperationType) == width, "Operation and storage types must have the same width");
+    static_assert(((Srcs::elementWidth == width) && ...), "Given vectors have different widths");
+
+    const size_t vLen = ((srcs.getMode() == RegisterMode::Scalar) || ...) ? 1 : N;
+    const bool zeroing = ((srcs.getPredMode() == PredicateMode::Zeroing) && ...);
+    /* Only the elements in use are copied out, one source after the other */
+    std::array<std::array<StorageType, N>, sizeof...(Srcs)> elements;
+    size_t source = 0;
+    ((std::copy_n(srcs.readElements().begin(), N, elements[source++].begin())), ...);
+    const size_t validElements = std::min({vLen, srcs.getValidElements()...});
+    auto out = dest.getElementsView();
+
+    /* Lanes written with a result and lanes written with either a result or
+    cleared by the tail policy. Only the mask words covering N elements are
+    built */
+    constexpr size_t lanes = std::min(N, predMask_t::wordBits / width);
+    constexpr size_t words = N / lanes;
+    const bool clearTail = tail == TailPolicy::AlwaysZero || zeroing;
+    const auto predicate = pred.getPredicate();
+    std::array<std::uint64_t, words> written, touched;
+    for (size_t w = 0; w < words; w++) {
+        const std::uint64_t valid = predMask_t::lowWord(validElements * width, w);
+        written[w] = predicate.words[w] & valid;
+        touched[w] = clearTail ? written[w] | (predMask_t::lowWord(vLen * width, w) & ~valid) : written[w];
+    }
+    auto isSet = [](const std::array<std::uint64_t, words> &m, size_t i) {
+        return (m[i / lanes] >> ((i % lanes + 1) * width - 1)) & 1;
+    };
+
+    auto apply = [&]<size_t... k>(std::index_sequence<k...>, size_t i) {
+        if constexpr (std::is_invocable_v<Op, decltype((void)k, OperationType{})..., OperationType>)
+            return toStorage<StorageType, OperationType>(op(readAS<OperationType>(elements[k][i])..., readAS<OperationType>(out[i])));
+        else
+            return toStorage<StorageType, OperationType>(op(readAS<OperationType>(elements[k][i])...));
+    };
+    constexpr auto sources = std::index_sequence_for<Srcs...>{};
+
+    if constexpr (Evaluation == LaneEvaluation::AllLanes) {
+        /* Lane masks keep the blend free of branches */
+        std::array<StorageType, N> results, writeMask, keepMask;
+        for (size_t i = 0; i < N; i++)
+            results[i] = apply(sources, i);
+        /* Flags are expanded a mask word at a time */
+        for (size_t w = 0; w < words; w++) {
+            for (size_t l = 0; l < lanes; l++) {
+                const size_t flag = (l + 1) * width - 1;
+                writeMask[w * lanes + l] = (written[w] >> flag) & 1 ? ~StorageType(0) : 0;
+                keepMask[w * lanes + l] = (touched[w] >> flag) & 1 ? 0 : ~StorageType(0);
+            }
+        }
+        for (size_t i = 0; i < N; i++)
+            out[i] = (results[i] & writeMask[i]) | (out[i] & keepMask[i]);
+    } else {
+        for (size_t i = 0; i < vLen; i++) {
+            if (isSet(written, i))
+                out[i] = apply(sources, i);
+            else if (isSet(touched, i))
+                out[i] = 0;
+        }
+    }
+
+    dest.setMode(mode == ResultMode::FollowSources && vLen == 1 ? RegisterMode::Scalar : RegisterMode::Vector);
+    dest.setElements(out);
+}
+
+/* Element-wise operation of the given sources into dest. op takes one operand
+per source, in OperationType, plus the current value of the destination
+element if it accepts it (for accumulations). Sources are read in order, as
+reading a load stream advances it. The lane loops are instantiated for every
+supported register length, so each runs over a compile-time element count */
+template <typename OperationType, LaneEvaluation Evaluation = LaneEvaluation::AllLanes, typename Dest, typename Op, typename... Srcs>
+void streamElementwise(Dest &dest, const predRegister_t &pred, const TailPolicy tail, const ResultMode mode, Op op, Srcs &...srcs) {
+    withRegisterLength(dest.getRegisterLength(), [&](auto length) {
+        streamElementwiseOf<decltype(length)::value / Dest::elementWidth, OperationType, Evaluation>(dest, pred, tail, mode, op, srcs...);
+    });
+}
+
+/* Folds the first validElements elements active in pred into acc, in order */
+template <typename OperationType, typename Elements, typename Op>
+OperationType reduceElements(const Elements &elements, const size_t validElements, const predRegister_t &pred, OperationType acc, Op op) {
+    for (size_t i = 0; i < validElements; i++)
+        if (pred.isElementActive(i, sizeof(OperationType)))
+            acc = op(acc, readAS<OperationType>(elements[i]));
+    return acc;
+}
+
+/* --- Widening kernels --- */
+
+/* Element-wise operation into a destination with elements Ratio times as wide
+as those of the sources. A source register then spans as many bytes as the
+destination, so destination lane j overlaps source lanes [j * Ratio, (j + 1) *
+Ratio), and accumulates the ones active in pred: it becomes group(dest[j], n,
+operands...), with the n active lanes of each source gathered at the front of
+an array of Ratio elements. Lanes with no active source lane are left alone,
+or cleared past the valid elements if every source is in zeroing mode */
+template <typename Dest, typename Group, typename... Srcs>
+void streamWidening(Dest &dest, const predRegister_t &pred, Group group, Srcs &...srcs) {
+    using WideType = typename Dest::ElementsType;
+    using NarrowType = typename std::tuple_element_t<0, std::tuple<Srcs...>>::ElementsType;
+    constexpr size_t ratio = sizeof(WideType) / sizeof(NarrowType);
+    static_assert(ratio > 1, "Widening destinations must be wider than their sources");
+    static_assert(((Srcs::elementWidth == sizeof(NarrowType)) && ...), "Given vectors have different widths");
+
+    const size_t narrowVLen = std::get<0>(std::tie(srcs...)).getVLen();
+    const size_t vLen = ((srcs.getMode() == RegisterMode::Scalar) || ...) ? 1 : narrowVLen;
+    const bool zeroing = ((srcs.getPredMode() == PredicateMode::Zeroing) && ...);
+    /* Braces read the sources in order, as reading a load stream advances it */
+    const std::tuple elements{srcs.readElements()...};
+    const size_t validElements = std::min({vLen, srcs.getValidElements()...});
+    auto out = dest.getElementsView();
+
+    for (size_t j = 0; j * ratio < vLen; j++) {
+        std::array<std::array<NarrowType, ratio>, sizeof...(Srcs)> operands;
+        size_t n = 0;
+        for (size_t i = j * ratio; i < std::min((j + 1) * ratio, validElements); i++) {
+            if (!pred.isElementActive(i, sizeof(NarrowType)))
+                continue;
+            size_t source = 0;
+            std::apply([&](const auto &...e) { ((operands[source++][n] = e[i]), ...); }, elements);
+            n++;
+        }
+        if (n > 0)
+            out[j] = std::apply([&](const auto &...o) { return WideType(group(out[j], n, o...)); }, operands);
+        else if (zeroing && j * ratio >= validElements)
+            out[j] = 0;
+    }
+
+    dest.setMode(vLen == 1 ? RegisterMode::Scalar : RegisterMode::Vector);
+    dest.setElements(out);
+}
+
+/* Widening reduction: the first validElements elements active in pred are
+gathered in order and folded into the wider accumulator acc at once, as
+fold(acc, n, elements) */
+template <typename WideType, typename NarrowType, size_t M, typename Fold>
+WideType reduceWidening(const std::array<NarrowType, M> &elements, const size_t validElements, const predRegister_t &pred, WideType acc, Fold fold) {
+    std::array<NarrowType, M> active;
+    size_t n = 0;
+    for (size_t i = 0; i < validElements; i++)
+        if (pred.isElementActive(i, sizeof(NarrowType)))
+            active[n++] = elements[i];
+    return n > 0 ? WideType(fold(acc, n, active)) : acc;
+}
+
+/* Binary32 accumulator plus the dot product of the first n elements of a and
+b, 8-bit elements in the OCP format of the unit and 16-bit ones as bfloat16.
+The products are summed exactly by the bulk-normalisation model of the Zvfbdot
+instructions, and the sum added to the accumulator, rounding to nearest even.
+Exception flags are dropped like those of every UVE operation */
+template <typename T, size_t M>
+std::uint32_t bulkDotAccumulate(const streamingUnit_t &su, std::uint32_t acc, size_t n, const std::array<T, M> &a, const std::array<T, M> &b) {
+    static_assert(sizeof(T) <= sizeof(std::uint16_t), "Only 8- and 16-bit elements have a bulk dot product");
+    auto dot = [&](auto format) {
+        using Format = decltype(format);
+        std::array<Format, M> x, y;
+        std::copy_n(a.begin(), n, x.begin());
+        std::copy_n(b.begin(), n, y.begin());
+        const DotConfig cfg(n, std::bit_width(n - 1));
+        if constexpr (std::is_same_v<Format, bf16_t>)
+            return bulk_norm_dot_bf16(cfg, x.data(), y.data());
+        else
+            return bulk_norm_dot_ofp8(cfg, x.data(), y.data());
+    };
+
+    fp16Scope_t scope;
+    bulk_norm_out_t sum;
+    if constexpr (sizeof(T) == sizeof(std::uint16_t))
+        sum = dot(bf16_t{});
+    else if (su.getFp8Format() == Fp8Format::E5M2)
+        sum = dot(ofp8_e5m2{});
+    else
+        sum = dot(ofp8_e4m3{});
+    return f32_add(float32_t{sum.out}, float32_t{acc}).v;
+}
+
+/* The same summing the elements of a, as a dot product with ones */
+template <typename T, size_t M>
+std::uint32_t bulkSumAccumulate(const streamingUnit_t &su, std::uint32_t acc, size_t n, const std::array<T, M> &a) {
+    std::array<T, M> ones;
+    if constexpr (sizeof(T) == sizeof(std::uint16_t))
+        ones.fill(0x3f80);
+    else
+        ones.fill(su.getFp8Format() == Fp8Format::E5M2 ? 0x3c : 0x38);
+    return bulkDotAccumulate(su, acc, n, a, ones);
+}
+
+/* Calls f with the computation type of 16-bit floating-point elements, in the
+format of the unit, and returns what it returns */
+template <typename F>
+decltype(auto) withFp16Type(const streamingUnit_t &su, F &&f) {
+    fp16Scope_t scope;
+    if (su.getFp16Format() == Fp16Format::BFloat16)
+        return f(bfloat_t{});
+    return f(half_t{});
+}
+
+#endif // STREAMING_KERNELS_HPP
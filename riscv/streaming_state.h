@@ -0,0 +1,80 @@
+#ifndef STREAMING_STATE_HPP
+#define STREAMING_STATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+/* --- Streaming Unit State Serialisation --- */
+
+/* Saved state is a flat sequence of fixed-width values in host byte order,
+with no padding or tags in between: what each value is follows from the ones
+before it. See streamingUnit_t::saveState for the layout */
+
+struct stateWriter_t {
+    std::vector<std::uint8_t> &out;
+
+    template <typename T>
+    void put(const T value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const size_t at = out.size();
+        out.resize(at + sizeof(T));
+        std::memcpy(&out[at], &value, sizeof(T));
+    }
+
+    void putBytes(const void *data, size_t n) {
+        const auto *bytes = static_cast<const std::uint8_t *>(data);
+        out.insert(out.end(), bytes, bytes + n);
+    }
+};
+
+/* Reading past the end of the data, or a value a caller rejects, fails the
+reader. Every later read then returns zeroes, so restoring code only checks for
+failure once it is done */
+struct stateReader_t {
+    std::span<const std::uint8_t> in;
+    size_t position = 0;
+    bool failed = false;
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value{};
+        getBytes(&value, sizeof(T));
+        return value;
+    }
+
+    /* Reads an enumeration stored as a byte, which must be below count */
+    template <typename E>
+    E getEnum(size_t count) {
+        const std::uint8_t value = get<std::uint8_t>();
+        return E(check(value < count) ? value : 0);
+    }
+
+    /* Reads a count stored as a T, which must not exceed max */
+    template <typename T>
+    size_t getCount(size_t max) {
+        const size_t n = get<T>();
+        return check(n <= max) ? n : 0;
+    }
+
+    void getBytes(void *data, size_t n) {
+        if (failed || in.size() - position < n) {
+            failed = true;
+            std::memset(data, 0, n);
+            return;
+        }
+        std::memcpy(data, &in[position], n);
+        position += n;
+    }
+
+    bool check(bool condition) {
+        failed |= !condition;
+        return !failed;
+    }
+};
+
+#endif // STREAMING_STATE_HPP
@@ -0,0 +1,66 @@
+#include "streaming_timing.h"
+#include <algorithm>
+#include <utility>
+
+streamTiming_t::streamTiming_t(size_t streamCount, size_t fifoDepth, size_t bandwidth, size_t latency)
+    : fifos(streamCount), fifoDepth(fifoDepth), bandwidth(bandwidth), latency(latency) {}
+
+void streamTiming_t::configure(size_t stream) {
+    fifo_t &fifo = fifos.at(stream);
+    fifo.chunks.clear();
+    fifo.configuredAt = now;
+    fifo.primed = false;
+}
+
+std::uint64_t streamTiming_t::load(size_t stream, size_t bytes) {
+    if (!bytes)
+        return 0;
+    fifo_t &fifo = fifos.at(stream);
+    /* Chunks are assumed to be as large as the one being consumed, as the
+    size of the next ones is only known when they are accessed */
+    if (!fifo.primed) {
+        for (size_t i = 0; i < fifoDepth; i++)
+            fifo.chunks.push_back(transfer(fifo.configuredAt, bytes) + latency);
+        fifo.primed = true;
+    }
+
+    const std::uint64_t stall = stallUntil(fifo.chunks.front());
+    fifo.chunks.pop_front();
+    /* The slot just freed is refilled with the next chunk */
+    fifo.chunks.push_back(transfer(now, bytes) + latency);
+    return stall;
+}
+
+std::uint64_t streamTiming_t::store(size_t stream, size_t bytes) {
+    if (!bytes)
+        return 0;
+    fifo_t &fifo = fifos.at(stream);
+    while (!fifo.chunks.empty() && fifo.chunks.front() <= now)
+        fifo.chunks.pop_front();
+
+    std::uint64_t stall = 0;
+    if (fifo.chunks.size() >= fifoDepth) {
+        stall = stallUntil(fifo.chunks.front());
+        fifo.chunks.pop_front();
+    }
+    fifo.chunks.push_back(transfer(now, bytes));
+    return stall;
+}
+
+std::uint64_t streamTiming_t::takeStallCycles() {
+    return std::exchange(pendingStalls, 0);
+}
+
+std::uint64_t streamTiming_t::transfer(std::uint64_t at, size_t bytes) {
+    portFree = std::max(at, portFree) + (bytes + bandwidth - 1) / bandwidth;
+    return portFree;
+}
+
+std::uint64_t streamTiming_t::stallUntil(std::uint64_t cycle) {
+    if (cycle <= now)
+        return 0;
+    const std::uint64_t stall = cycle - now;
+    now = cycle;
+    pendingStalls += stall;
+    return stall;
+}
@@ -0,0 +1,61 @@
+#ifndef STREAMING_TIMING_HPP
+#define STREAMING_TIMING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/* --- Streaming Engine Timing Model --- */
+
+/* Streams are loaded and stored synchronously by the instructions using them.
+This model estimates what they would cost with a decoupled Streaming Engine
+instead. Every stream has a FIFO of fifoDepth chunks, one per register access,
+that the engine fills ahead of the consumer (loads) or drains behind the
+producer (stores). All streams share a memory port moving bandwidth bytes per
+cycle, and loaded data arrives latency cycles after its transfer.
+An instruction consuming a load chunk that has not arrived, or producing a
+store chunk while the FIFO is full of chunks not yet written, stalls until it
+can proceed. Time advances one cycle per retired instruction, plus stalls */
+struct streamTiming_t {
+    streamTiming_t(size_t streamCount, size_t fifoDepth, size_t bandwidth, size_t latency);
+
+    void retire() {
+        now++;
+    }
+
+    /* The engine starts fetching a stream once it is configured */
+    void configure(size_t stream);
+
+    /* A register access of the given size. Both return the cycles the
+    instruction stalled */
+    std::uint64_t load(size_t stream, size_t bytes);
+    std::uint64_t store(size_t stream, size_t bytes);
+
+    /* Returns the stall cycles since the previous call and clears them */
+    std::uint64_t takeStallCycles();
+
+private:
+    struct fifo_t {
+        /* Arrival times of loaded chunks, or completion times of stored ones */
+        std::deque<std::uint64_t> chunks;
+        std::uint64_t configuredAt = 0;
+        bool primed = false;
+    };
+
+    std::vector<fifo_t> fifos;
+    const size_t fifoDepth;
+    const size_t bandwidth;
+    const size_t latency;
+
+    std::uint64_t now = 0;
+    std::uint64_t portFree = 0;
+    std::uint64_t pendingStalls = 0;
+
+    /* Transfers bytes through the memory port, no earlier than at, and
+    returns the cycle the transfer ends */
+    std::uint64_t transfer(std::uint64_t at, size_t bytes);
+    std::uint64_t stallUntil(std::uint64_t cycle);
+};
+
+#endif // STREAMING_TIMING_HPP
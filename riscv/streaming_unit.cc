@@ -1,53 +1,130 @@
 #include "streaming_unit.h"
 #include "mmu.h"
 #include "processor.h"
+#include <algorithm>
+#include <cinttypes>
 
 #define gMMU(p) (*(p->get_mmu()))
 
+/* Collects the traced memory accesses of a register fill and hands them to
+the memory tracers as one batch tagged with the stream register, also when a
+trap cuts the fill short. With commits logged, the per-element log entries of
+the fill are folded into runs of equally spaced elements */
+struct streamTraceScope_t {
+    streamTraceScope_t(processor_t *p, size_t stream, access_type type) :
+     mmu(gMMU(p)), state(p->get_log_commits_enabled() ? p->get_state() : nullptr), stream(stream), type(type) {
+        previous = mmu.capture_traces(&ranges);
+        if (state)
+            logged = logEntries().size();
+    }
+
+    ~streamTraceScope_t() {
+        mmu.capture_traces(previous);
+        mmu.trace_stream(stream, ranges, type);
+        if (state)
+            compactLog();
+    }
+
+private:
+    mmu_t &mmu;
+    state_t *const state;
+    const size_t stream;
+    const access_type type;
+    std::vector<memtrace_range_t> ranges;
+    std::vector<memtrace_range_t> *previous;
+    size_t logged = 0;
+
+    commit_log_mem_t &logEntries() const {
+        return type == STORE ? state->log_mem_write : state->log_mem_read;
+    }
+
+    void compactLog() {
+        commit_log_mem_t &entries = logEntries();
+        auto &runs = state->log_stream_mem;
+        const bool store = type == STORE;
+        for (size_t i = logged; i < entries.size(); i++) {
+            const auto [addr, value, size] = entries[i];
+            if (i > logged) { // the previous entry of this fill ended a run
+                auto &run = runs.back();
+                const int64_t step = addr - (run.addr + run.stride * (run.count - 1));
+                if (run.size == size && (run.count == 1 || step == run.stride)) {
+                    if (run.count == 1)
+                        run.stride = step;
+                    run.count++;
+                    continue;
+                }
+            }
+            runs.push_back({addr, 0, 1, size, uint8_t(stream), store});
+        }
+        entries.resize(logged);
+    }
+};
+
+/* Pattern of an affine stream for the memory tracers, walking a copy of its
+descriptor the way register fills walk the stream. Elements in pages not
+present in the TLB are not known until the stream itself reaches them */
+struct streamPattern_t : stream_pattern_t {
+    streamPattern_t(const descriptorIterator_t &descriptor, mmu_t &mmu) : descriptor(descriptor), mmu(mmu) {}
+
+    std::unique_ptr<stream_pattern_t> clone() const override {
+        return std::make_unique<streamPattern_t>(*this);
+    }
+
+    bool next(uint64_t &paddr) override {
+        while (!pending) {
+            if (descriptor.isStreamDone())
+                return false;
+            size_t address;
+            const bool generated = descriptor.tryGenerateAddress(address);
+            if (generated) {
+                pending = address;
+                size_t following;
+                if (!descriptor.isStreamDone())
+                    descriptor.tryGenerateAddress(following);
+            }
+            if (!descriptor.isStreamDone())
+                descriptor.updateIteration();
+        }
+
+        reg_t translated;
+        if (!mmu.probe_tlb(*pending, translated))
+            return false;
+        paddr = translated;
+        pending.reset();
+        return true;
+    }
+
+private:
+    descriptorIterator_t descriptor;
+    mmu_t &mmu;
+    std::optional<size_t> pending;
+};
+
 template <typename T>
 void streamRegister_t<T>::addStaticModifier(staticModifier_t mod) {
-    assert_msg("Cannot append more modifiers as max dimensions were reached", dimensions.size() + 1 < su->maxDimensions);
-    // staticModifiers.insert({0, mod});
+    assert_msg("Cannot append more modifiers as max dimensions were reached", descriptor.getDimensionCount() + 1 < su->maxDimensions);
     //  add a static modifier to the current dimension
-    staticModifiers.insert({dimensions.size() - 1, mod});
-    /* print modifiers
-    std::cout << "\nModifiers: ";
-    for (auto &m : modifiers)
-        std::cout << m.first << "  ";
-    std::cout << std::endl;*/
+    descriptor.addStaticModifier(mod);
 }
 
 template <typename T>
 void streamRegister_t<T>::addDynamicModifier(dynamicModifier_t mod) {
-    assert_msg("Cannot append more modifiers as max dimensions were reached", dimensions.size() + 1 < su->maxDimensions);
-    // dynamicModifiers.insert({0, mod});
+    assert_msg("Cannot append more modifiers as max dimensions were reached", descriptor.getDimensionCount() + 1 < su->maxDimensions);
     //  add a dynamic modifier to the current dimension
-    dynamicModifiers.insert({dimensions.size() - 1, mod});
-    /* print modifiers
-    std::cout << "\nModifiers: ";
-    for (auto &m : modifiers)
-        std::cout << m.first << "  ";
-    std::cout << std::endl;*/
+    descriptor.addDynamicModifier(mod);
 }
 
 template <typename T>
 void streamRegister_t<T>::addScatterGModifier(scatterGModifier_t mod) {
-    assert_msg("Cannot append more modifiers as max dimensions were reached", dimensions.size() + 1 < su->maxDimensions);
-    scatterGModifiers.insert({0, mod});
-    /* print modifiers
-    std::cout << "\nModifiers: ";
-    for (auto &m : modifiers)
-        std::cout << m.first << "  ";
-    std::cout << std::endl;*/
+    assert_msg("Cannot append more modifiers as max dimensions were reached", descriptor.getDimensionCount() + 1 < su->maxDimensions);
+    descriptor.addScatterGModifier(mod);
 }
 
 template <typename T>
 void streamRegister_t<T>::addDimension(dimension_t dim) {
-    assert_msg("Cannot append more dimensions as the max value was reached", dimensions.size() < su->maxDimensions);
-
-    dimensions.push_back(dim);
+    assert_msg("Cannot append more dimensions as the max value was reached", descriptor.getDimensionCount() < su->maxDimensions);
 
-    std::unordered_multimap<int, staticModifier_t> updatedModifiers;
+    descriptor.addDimension(dim);
 }
 
 template <typename T>
@@ -55,36 +132,34 @@ void streamRegister_t<T>::configureVecDim(const int cfgIndex) {
     mode = RegisterMode::Vector;
     if (type != RegisterConfig::Load)
         validElements = vLen;
-    vecCfgDim = cfgIndex;
+    descriptor.configureVecDim(cfgIndex);
 }
 
 template <typename T>
 void streamRegister_t<T>::startConfiguration(size_t base_address) {
     status = RegisterStatus::NotConfigured;
     mode = RegisterMode::Scalar;
-    baseAddress = base_address;
-    dimensions.clear();
+    descriptor.startConfiguration(base_address, elementWidth);
+    indexCount = indexNext = 0;
 }
 
 template <typename T>
 void streamRegister_t<T>::endConfiguration() {
     status = RegisterStatus::Running;
 
-    // If vecCfgDim is -1, then the innermost dimension is the vector coupled dimension
-    if (vecCfgDim == -1)
-        vecCfgDim = dimensions.size() - 1;
-
-    // Apply all dynamic modifiers for the first iteration
-    for (size_t i = 0; i < dimensions.size(); i++) {
-        // std::cout << "u" << registerN << "    Applying dynamic modifiers to dim " << i << std::endl;
-        auto dynamicModifierIters = dynamicModifiers.equal_range(i);
-        for (auto it = dynamicModifierIters.first; it != dynamicModifierIters.second; ++it) {
-            // std::cout << "u" << registerN << "    Applying dynamic modifier to dim " << i << std::endl;
-            it->second.modDimension(dimensions, elementWidth);
+    // Resolves the vector coupled dimension and applies all dynamic modifiers for the first iteration
+    descriptor.endConfiguration();
+
+    if (type != RegisterConfig::NoStream) {
+        (descriptor.isShapeReused() ? su->configurationHits : su->configurationMisses)++;
+        if (su->p && gMMU(su->p).has_memtracers()) {
+            const std::optional<streamPattern_t> pattern = descriptor.isAffine() ? std::optional<streamPattern_t>(std::in_place, descriptor, gMMU(su->p)) : std::nullopt;
+            gMMU(su->p).stream_configured(registerN, pattern ? &*pattern : nullptr);
         }
     }
-
-    su->updateEODTable(registerN);
+    if (su->timing)
+        su->timing->configure(registerN);
+    su->updateEODTable(registerN, descriptor.getEndOfDimensionMask(), descriptor.getDimensionCount());
 }
 
 template <typename T>
@@ -93,43 +168,131 @@ void streamRegister_t<T>::finishStream() {
     type = RegisterConfig::NoStream;
 
     // Mark all dimensions as finished in EODTable to avoid wrong branching
-    for (dimension_t &dim : dimensions)
-        dim.setEndOfDimension(true);
-    su->updateEODTable(registerN);
+    descriptor.finish();
+    su->updateEODTable(registerN, descriptor.getEndOfDimensionMask(), descriptor.getDimensionCount());
+}
+
+template <typename T>
+void streamRegister_t<T>::update() {
+    try {
+        if (su->takeReplay(registerN)) {
+            fillComplete = true;
+            finishPendingIteration();
+        } else {
+            fillComplete = false;
+            if (type == RegisterConfig::Store)
+                updateAsStore();
+            else
+                updateAsLoad();
+        }
+        su->recordFill(registerN);
+    } catch (...) {
+        if (fillComplete)
+            su->recordFill(registerN);
+        su->abortInstruction();
+        throw;
+    }
 }
 
 template <typename T>
-std::vector<T> streamRegister_t<T>::getElements(bool causesUpdate) {
+void streamRegister_t<T>::finishPendingIteration() {
+    if (iterationPending) {
+        updateIteration();
+        iterationPending = false;
+    }
+}
+
+template <typename T>
+typename streamRegister_t<T>::ElementsStorage streamRegister_t<T>::getElements(bool causesUpdate) {
     // std::cout << "u" << registerN << "    Getting elements" << std::endl;
     if (causesUpdate && this->type == RegisterConfig::Load)
-        updateAsLoad();
+        update();
+
+    return elements;
+}
 
-    std::vector<T> e(elements.begin(), elements.end());
+template <typename T>
+std::span<const T, streamRegister_t<T>::maxVLen> streamRegister_t<T>::readElements(bool causesUpdate) {
+    if (causesUpdate && this->type == RegisterConfig::Load)
+        update();
 
-    return e;
+    return elements;
+}
+
+/* Gives direct access to the register contents without iterating the stream.
+Results written through the view are only stored to memory once they are
+handed back with setElements */
+template <typename T>
+std::span<T, streamRegister_t<T>::maxVLen> streamRegister_t<T>::getElementsView() {
+    return elements;
 }
 
 template <typename T>
 bool streamRegister_t<T>::getDynModElement(int &value) {
-    assert_msg("Dynamic modifier source is not correctly configured", type == RegisterConfig::IndSource);
+    /* Indices already buffered are still handed out once the stream finished */
+    assert_msg("Dynamic modifier source is not correctly configured", type == RegisterConfig::IndSource || indexNext < indexCount);
 
     // std::cout << "u" << registerN << "    Getting modifier element" << std::endl;
 
-    updateAsLoad();
+    if (indexNext == indexCount)
+        reserveIndices(1);
+    if (indexNext == indexCount)
+        fetchIndices();
 
-    value = readAS<int>(elements.at(0));
+    elements[0] = indexBuffer[indexNext++];
+    value = readAS<int>(elements[0]);
 
-    return !hasStreamFinished();
+    return indexNext < indexCount || !hasStreamFinished();
 }
 
+/* A vector source loads a whole register per index, of which only the first
+element is used, so it never holds more than one index */
 template <typename T>
-void streamRegister_t<T>::setElements(std::vector<T> e, bool causesUpdate) {
+void streamRegister_t<T>::reserveIndices(size_t n) {
+    if (indexCount - indexNext >= n || hasStreamFinished())
+        return;
+    if (mode == RegisterMode::Vector) {
+        if (indexNext == indexCount) {
+            auto bufferFirst = [this] {
+                indexBuffer[0] = elements[0];
+                indexNext = 0;
+                indexCount = 1;
+            };
+            fillComplete = false;
+            try {
+                updateAsLoad();
+            } catch (...) {
+                if (fillComplete) // only the update after the fill trapped
+                    bufferFirst();
+                throw;
+            }
+            bufferFirst();
+        }
+        return;
+    }
+    fetchIndices();
+}
+
+template <typename T>
+void streamRegister_t<T>::setElements(std::span<const T> e, bool causesUpdate) {
     // assert_msg("Trying to set values to a load stream", type != RegisterConfig::Load && type != RegisterConfig::IndSource);
+    assert_msg("Trying to set more elements than the register holds", e.size() <= maxVLen);
 
-    elements = e;
+    /* Results built in place through getElementsView need no copy */
+    if (e.data() != elements.data()) {
+        std::copy(e.begin(), e.end(), elements.begin());
+        std::fill(elements.begin() + e.size(), elements.end(), 0);
+    }
 
+    logWrite();
     if (causesUpdate && this->type == RegisterConfig::Store)
-        updateAsStore();
+        update();
+}
+
+template <typename T>
+void streamRegister_t<T>::logWrite() const {
+    if (su && su->p && su->p->get_log_commits_enabled())
+        su->p->get_state()->log_reg_write[(registerN << 4) | 5] = {0, 0};
 }
 
 template <typename T>
@@ -162,8 +325,7 @@ bool streamRegister_t<T>::hasStreamFinished() const {
 
 template <typename T>
 bool streamRegister_t<T>::isEndOfDimensionOfDim(size_t i) const {
-    assert_msg("Trying to check EOD of invalid dimension", i < dimensions.size());
-    return dimensions.at(i).isEndOfDimension();
+    return descriptor.isEndOfDimension(i);
 }
 
 template <typename T>
@@ -176,6 +338,11 @@ size_t streamRegister_t<T>::getVLen() const {
     return vLen;
 }
 
+template <typename T>
+size_t streamRegister_t<T>::getRegisterLength() const {
+    return vLen * elementWidth;
+}
+
 template <typename T>
 size_t streamRegister_t<T>::getValidElements() const {
     return validElements;
@@ -210,194 +377,49 @@ void streamRegister_t<T>::printRegN(char *str) {
         fprintf(stderr, ">>> Register number not set for debugging. %s<<<", str);
 }
 
-template <typename T>
-size_t streamRegister_t<T>::generateAddress() {
-    /* Result will be the final accumulation of all offsets calculated per dimension */
-    size_t init = baseAddress; // base address of the stream
-    int dimN = 0;
-
-    // std::cout << "u" << registerN << ": Generating address." << std::endl;
-
-    return std::accumulate(dimensions.rbegin(), dimensions.rend(), init, [&](size_t acc, dimension_t &dim) {
-        if (dim.isLastIteration() && isDimensionFullyDone(dimensions.end() - dimN, dimensions.end()))
-            dim.setEndOfDimension(true);
-        ++dimN;
-        // std::cout << "u" << registerN << "    Calculating address for dim " << dimensions.size() - dimN + 1 << std::endl;
-        return acc + dim.calcAddress(elementWidth);
-    });
-}
-
-template <typename T>
-bool streamRegister_t<T>::isDimensionFullyDone(const std::deque<dimension_t>::const_iterator start, const std::deque<dimension_t>::const_iterator end) const {
-    return std::accumulate(start, end, true, [](bool acc, const dimension_t &dim) {
-        return acc && dim.isEndOfDimension();
-    });
-    ;
-}
-
 template <typename T>
 bool streamRegister_t<T>::isStreamDone() const {
-    // return isDimensionFullyDone(dimensions.begin(), dimensions.end());
-    return dimensions.at(0).isEndOfDimension();
+    return descriptor.isStreamDone();
 }
 
 template <typename T>
 bool streamRegister_t<T>::tryGenerateAddress(size_t &address) {
-    /* There are two situations that prevent us from generating offsets/iterating a stream:
-    1) We are at the last iteration of the outermost dimension
-    2) We just finished the last iteration of a dimension and there is a configure
-    stream vector modifier at that same dimension. In these cases, the generation can
-    only resume after an exterior call to setEndOfDimension(false) */
-
-    /* The outermost dimension is the last one in the container */
-
+    /* The stream finishes once its outermost dimension ends */
     if (isStreamDone()) {
-        /*if (registerN == 3)
-            std::cout << "u" << registerN << " Stream is done HERE GENERATE" << std::endl;*/
         finishStream();
         return false;
     }
 
-    bool canGenerateAddress = true;
-
-    for (int i = int(dimensions.size() - 1); i >= 0; i--) {
-        applySGMods(i);
-        if (dimensions.at(i).isEmpty()) {
-            for (int j = i; j < int(dimensions.size()); j++)
-                dimensions.at(j).setEndOfDimension(true);
-            canGenerateAddress = false;
-        }
-        if (i == vecCfgDim && isDimensionFullyDone(dimensions.begin() + i, dimensions.end())){
-            canGenerateAddress =  false;
-            break;
-        }
-    }
-
-    address = generateAddress();
-    return canGenerateAddress;
-}
-
-template <typename T>
-void streamRegister_t<T>::applySGMods(size_t dimN) {
-    auto currentModifierIters1 = scatterGModifiers.equal_range(dimN);
-    for (auto it = currentModifierIters1.first; it != currentModifierIters1.second; ++it) {
-        if (!it->second.isApplied()) {
-            // std::cout << "u" << registerN << "    Applying scatter-gather modifier to dim " << dimN << std::endl;
-            it->second.modDimension(dimensions.at(dimN), elementWidth);
-        }
-    }
-}
-
-template <typename T>
-void streamRegister_t<T>::setDynamicModsNotApplied(size_t dimN) {
-    auto currentModifierIters = dynamicModifiers.equal_range(dimN);
-    for (auto it = currentModifierIters.first; it != currentModifierIters.second; ++it)
-        it->second.setApplied(false);
-}
-
-template <typename T>
-void streamRegister_t<T>::setSGModsNotApplied(size_t dimN) {
-    auto currentModifierIters = scatterGModifiers.equal_range(dimN);
-    for (auto it = currentModifierIters.first; it != currentModifierIters.second; ++it)
-        it->second.setApplied(false);
+    return descriptor.tryGenerateAddress(address);
 }
 
 template <typename T>
 void streamRegister_t<T>::updateIteration() {
-    // std::cout << "u" << registerN << ": Updating iteration STARTED." << std::endl;
-
     if (isStreamDone()) {
         finishStream();
-        /*if (registerN == 3)
-            std::cout << "u" << registerN << " Stream is done HERE ITER" << std::endl;*/
         return;
     }
 
-    /* Iteration starts from the innermost dimension and updates the next if the current reaches an overflow */
-    // std::cout << "Updating iteration. Dimension " << dimensions.size() << std::endl;
-    bool validIter;
-    /*if (registerN == 3)
-        std::cout << "Updating iteration. Dimension " << dimensions.size() << std::endl;*/
-    validIter = dimensions.back().advance();
-    /*if (registerN == 3)
-        std::cout << "u" << registerN << " ValidIter: " << validIter << std::endl;*/
-
-    for (int i = dimensions.size() - 1; i > 0; --i) {
-        auto &currDim = dimensions.at(i);
-        /* The following calculations are only necessary if we ARE in the
-        last iteration of a dimension */
-
-        if (currDim.isEndOfDimension()) {
-
-            // std::cout << "u" << registerN << " EOD: dim " << i + 1 << " ended" << std::endl;
-
-            // If modifiers exist, the values at targetted dimensions might have been modified.
-            // As such, we need to reset them before next iteration.
-            if (validIter) {
-                auto currentModifierIters = staticModifiers.equal_range(i);
-                for (auto it = currentModifierIters.first; it != currentModifierIters.second; ++it) {
-                    int target = it->second.getTargetDim();
-                    // std::cout << "dim " << i + 1 << ": Resetting dim " << target + 1 << std::endl;
-                    dimensions.at(target).resetIterValues();
-                }
-            }
-            // If dynamic modifiers exist, we also need to apply them before the first iteration of the target dimension.
-            /*auto currentDynaminModifierIters = dynamicModifiers.equal_range(i);
-            for (auto it = currentDynaminModifierIters.first; it != currentDynaminModifierIters.second; ++it) {
-                int target = it->second.getTargetDim();
-                dimensions.at(target).resetIterValues();
-                if (registerN == 3) {
-                    std::cout << "u" << registerN << "   Dim "<< i+1 << " ended: Applying dynamic modifier to dim " << target << std::endl;
-                }
-                it->second.modDimension(dimensions, elementWidth);
-            }*/
-
-            // Reset EOD flag of current dimension if iteration was successful
-            currDim.setEndOfDimension(false);
-
-            auto &nextDim = dimensions.at(i - 1);
-
-            // Unflag dynamic modifiers of current dimension
-            // setDynamicModsNotApplied(i);
-
-            // Iterate upper dimension
-            validIter = nextDim.advance();
-            /*if (registerN == 3)
-                std::cout << "u" << registerN << " ValidIter: " << validIter << std::endl;*/
-
-            // Unflag scatter dynamic modifiers of upper dimension
-            // setSGModsNotApplied(i+1);
-
-            if (validIter) {
-                // Apply static modifiers associated with upper dimension to target dimensions
-                auto upperModifierIters = staticModifiers.equal_range(i - 1);
-                for (auto it = upperModifierIters.first; it != upperModifierIters.second; ++it) {
-                    // std::cout << "dim " << i << ": Applying static modifier to dim " << it->second.getTargetDim() + 1 << std::endl;
-                    it->second.modDimension(dimensions, elementWidth);
-                }
-
-                // Apply dynamic modifiers associated with upper dimension to target dimensions
-                auto upperDynamicModifierIters = dynamicModifiers.equal_range(i - 1);
-                for (auto it = upperDynamicModifierIters.first; it != upperDynamicModifierIters.second; ++it) {
-                    int target = it->second.getTargetDim();
-                    /*if (registerN == 3) {
-                        std::cout << "u" << registerN << ": Applying dynamic modifier to dim " << target << std::endl;
-                    }*/
-                    if (nextDim.isLastIteration())
-                        nextDim.resetIterValues();
-                    it->second.modDimension(dimensions, elementWidth);
-                }
-            }
-        }
-    }
+    descriptor.updateIteration();
+}
 
-    // std::cout << "u" << registerN << ": Updating iteration ENDED." << std::endl;
+template <typename T>
+typename streamRegister_t<T>::ElementsType streamRegister_t<T>::loadElement(size_t address) {
+    if constexpr (std::is_same_v<ElementsType, std::uint8_t>)
+        return readAS<ElementsType>(gMMU(su->p).template load<std::uint8_t>(address));
+    else if constexpr (std::is_same_v<ElementsType, std::uint16_t>)
+        return readAS<ElementsType>(gMMU(su->p).template load<std::uint16_t>(address));
+    else if constexpr (std::is_same_v<ElementsType, std::uint32_t>)
+        return readAS<ElementsType>(gMMU(su->p).template load<std::uint32_t>(address));
+    else
+        return readAS<ElementsType>(gMMU(su->p).template load<std::uint64_t>(address));
 }
 
 template <typename T>
 void streamRegister_t<T>::updateAsLoad() {
     assert_msg("Trying to update as load a non-load stream", type == RegisterConfig::Load || type == RegisterConfig::IndSource);
-    if (isStreamDone()) { // doesn't try to load if stream has finished
+    finishPendingIteration();
+    if (!fillInterrupted && isStreamDone()) { // doesn't try to load if stream has finished
         finishStream();
         /*if (registerN == 3)
             std::cout << "u" << registerN << " Stream is done HERE LOAD" << std::endl;*/
@@ -406,28 +428,36 @@ void streamRegister_t<T>::updateAsLoad() {
     // elements.clear();
     // elements.reserve(vLen);
 
-    size_t eCount = 0;
-    validElements = 0; // reset valid index
+    streamTraceScope_t trace(su->p, registerN, LOAD);
+    /* A fill cut short by a trap goes on from the element that trapped */
+    size_t eCount = fillInterrupted ? fillProgress : 0;
+    if (!fillInterrupted)
+        validElements = 0; // reset valid index
+    fillInterrupted = false;
 
     size_t offset;
 
     size_t max = mode == RegisterMode::Vector ? vLen : 1;
 
     // std::cout << "u" << registerN << ": Loading values." << std::endl;
-    int g = 0;
     //do {
-        //std::cout << "u" << registerN << ": Loading values. > " << g++ << std::endl;
-        while (eCount < max && tryGenerateAddress(offset)) {
-            auto value = [this](auto address) -> ElementsType {
-                if constexpr (std::is_same_v<ElementsType, std::uint8_t>)
-                    return readAS<ElementsType>(gMMU(su->p).template load<std::uint8_t>(address));
-                else if constexpr (std::is_same_v<ElementsType, std::uint16_t>)
-                    return readAS<ElementsType>(gMMU(su->p).template load<std::uint16_t>(address));
-                else if constexpr (std::is_same_v<ElementsType, std::uint32_t>)
-                    return readAS<ElementsType>(gMMU(su->p).template load<std::uint32_t>(address));
-                else
-                    return readAS<ElementsType>(gMMU(su->p).template load<std::uint64_t>(address));
-            }(offset);
+    try {
+        while (eCount < max) {
+            /* Unit-stride runs that sit in a single TLB-resident page are
+            copied at once straight from host memory */
+            if (size_t run = descriptor.contiguousRunLength(max - eCount, offset)) {
+                const size_t bytes = run * elementWidth;
+                if (auto host = gMMU(su->p).load_host_range(offset, bytes)) {
+                    std::memcpy(&elements[eCount], (const void *)host, bytes);
+                    eCount += run;
+                    validElements += run;
+                    descriptor.skipIterations(run);
+                }
+            }
+            if (!tryGenerateAddress(offset))
+                break;
+
+            auto value = loadElement(offset);
 
             // elements.push_back(value);
             /*if (registerN == 3 || registerN == 4)
@@ -436,19 +466,30 @@ void streamRegister_t<T>::updateAsLoad() {
             /*if (registerN==3)
                 std::cout << "u" << registerN << "    Loaded Value: " << readAS<double>(value) << std::endl;*/
             ++validElements;
-            for (size_t i = 0; i < dimensions.size(); i++)
-                setSGModsNotApplied(i);
+            descriptor.setSGModsNotApplied();
             if (tryGenerateAddress(offset) && ++eCount < max) {
+                iterationPending = true;
                 updateIteration(); // reset EOD flags and iterate stream
+                iterationPending = false;
             } else {
                 break;
             }
         }
-        su->updateEODTable(registerN); // save current state of the stream so that branches can catch EOD flags
+    } catch (...) {
+        fillInterrupted = true;
+        fillProgress = eCount;
+        throw;
+    }
+        su->updateEODTable(registerN, descriptor.getEndOfDimensionMask(), descriptor.getDimensionCount()); // save current state of the stream so that branches can catch EOD flags
+        recordAccess(true, validElements, max);
+        logWrite();
         // std::cout << "eCount: " << eCount << std::endl;
         // std::cout << "vLen: " << vLen << std::endl;
         // if (eCount < max) {    // iteration is already updated when register is full
+        fillComplete = true;
+        iterationPending = true;
         updateIteration(); // reset EOD flags and iterate stream
+        iterationPending = false;
         /*for (size_t i = 0; i < dimensions.size() - 1; i++)
             setDynamicModsNotApplied(i, true);*/
         /*for (size_t i = 0; i < dimensions.size(); i++)
@@ -461,13 +502,16 @@ template <typename T>
 void streamRegister_t<T>::updateAsStore() {
     assert_msg("Trying to update as store a non-store stream", type == RegisterConfig::Store);
     // std::cout << "Updating as store" << std::endl;
-    if (isStreamDone()) {
+    finishPendingIteration();
+    if (!fillInterrupted && isStreamDone()) {
         finishStream();
         return;
     }
     // std::cout << "Storing " << elements.size() << " elements. eCount=" << vLen << std::endl;
+    streamTraceScope_t trace(su->p, registerN, STORE);
     size_t offset;
-    size_t eCount = 0;
+    size_t eCount = fillInterrupted ? fillProgress : 0;
+    fillInterrupted = false;
 
     /*
     std::cout << "Storing " << validElements << " elements." << std::endl;
@@ -478,7 +522,21 @@ void streamRegister_t<T>::updateAsStore() {
     std::cout << std::endl;
     */
     //do {
-        while (eCount < validElements && tryGenerateAddress(offset)) {
+    try {
+        while (eCount < validElements) {
+            /* Contiguous elements are combined into a single copy to host
+            memory, under the same conditions as the load side */
+            if (size_t run = descriptor.contiguousRunLength(validElements - eCount, offset)) {
+                const size_t bytes = run * elementWidth;
+                if (auto host = gMMU(su->p).store_host_range(offset, bytes)) {
+                    std::memcpy((void *)host, &elements[eCount], bytes);
+                    eCount += run;
+                    descriptor.skipIterations(run);
+                }
+            }
+            if (!tryGenerateAddress(offset))
+                break;
+
             // auto value = elements.front();
             // elements.erase(elements.begin());
             // elements.pop_front(); //-- std::array
@@ -492,26 +550,174 @@ void streamRegister_t<T>::updateAsStore() {
                 gMMU(su->p).template store<std::uint32_t>(offset, readAS<ElementsType>(value));
             else
                 gMMU(su->p).template store<std::uint64_t>(offset, readAS<ElementsType>(value));
-            for (size_t i = 0; i < dimensions.size(); i++)
-                setSGModsNotApplied(i);
+            descriptor.setSGModsNotApplied();
             ++eCount;
             if (tryGenerateAddress(offset) && eCount < validElements) {
+                iterationPending = true;
                 updateIteration(); // reset EOD flags and iterate stream
+                iterationPending = false;
                 //++eCount;
             } else
                 break;
         }
+    } catch (...) {
+        fillInterrupted = true;
+        fillProgress = eCount;
+        throw;
+    }
         // std::cout << std::endl;
         // std::cout << "UPDATING EODTABLE" <<std::endl;
-        su->updateEODTable(registerN); // save current state of the stream so that branches can catch EOD flags
+        su->updateEODTable(registerN, descriptor.getEndOfDimensionMask(), descriptor.getDimensionCount()); // save current state of the stream so that branches can catch EOD flags
+        recordAccess(false, eCount, mode == RegisterMode::Vector ? vLen : 1);
                                        // if (eCount < validElements)       // iteration is already updated when register is full
+        fillComplete = true;
+        iterationPending = true;
         updateIteration();             // reset EOD flags and iterate stream
+        iterationPending = false;
         // elements.clear();
     //} while (eCount == 0 /*&& tryGenerateAddress(offset)*/);
 }
 
-std::vector<uint8_t> predRegister_t::getPredicate() const {
-    return elements;
+/* Runs up to a register worth of the scalar loads modifiers would otherwise
+trigger one at a time, each of them fetching at most one index. A load that
+finds no element to fetch repeats the previous index, as the register would.
+The EOD flags and statistics of the source are only updated once per batch */
+template <typename T>
+void streamRegister_t<T>::fetchIndices() {
+    streamTraceScope_t trace(su->p, registerN, LOAD);
+    /* Indices not handed out yet move to the front */
+    std::copy(indexBuffer.begin() + indexNext, indexBuffer.begin() + indexCount, indexBuffer.begin());
+    indexCount -= indexNext;
+    indexNext = 0;
+    const size_t buffered = indexCount;
+    ElementsType last = indexCount ? indexBuffer[indexCount - 1] : elements[0];
+    size_t loaded = 0;
+
+    try {
+        finishPendingIteration();
+        while (indexCount < vLen) {
+            if (isStreamDone()) {
+                finishStream();
+                indexBuffer[indexCount++] = last;
+                break;
+            }
+
+            size_t address;
+            if (tryGenerateAddress(address)) {
+                last = loadElement(address);
+                ++loaded;
+                descriptor.setSGModsNotApplied();
+                tryGenerateAddress(address);
+            }
+            indexBuffer[indexCount++] = last;
+
+            iterationPending = true;
+            updateIteration();
+            iterationPending = false;
+            if (hasStreamFinished())
+                break;
+        }
+    } catch (...) {
+        /* The batch ends at a trap, which is raised again by the next one,
+        unless there is no index left to hand out */
+        if (indexCount == buffered)
+            throw;
+    }
+
+    validElements = loaded ? 1 : 0;
+    su->updateEODTable(registerN, descriptor.getEndOfDimensionMask(), descriptor.getDimensionCount());
+    recordAccess(true, loaded, indexCount);
+}
+
+template <typename T>
+void streamRegister_t<T>::recordAccess(bool isLoad, size_t elements, size_t lanes) {
+    streamStats_t access;
+    (isLoad ? access.loadedElements : access.storedElements) = elements;
+    (isLoad ? access.loadedBytes : access.storedBytes) = elements * elementWidth;
+    access.fills = 1;
+    access.validElements = elements;
+    access.lanes = lanes;
+    const uint8_t eodMask = descriptor.getEndOfDimensionMask();
+    for (size_t i = 0; i < descriptor.getDimensionCount(); i++)
+        access.endOfDimension[i] = (eodMask >> i) & 1;
+    const auto activity = descriptor.takeActivity();
+    access.modifierApplications = activity.modifierApplications;
+    access.indexFetches = activity.indexFetches;
+    if (su->timing)
+        access.stallCycles = isLoad ? su->timing->load(registerN, elements * elementWidth) : su->timing->store(registerN, elements * elementWidth);
+    su->recordAccess(registerN, access);
+}
+
+/* The element width and EOD flags of the register are saved by the streaming
+unit. Only the first vLen elements are held, and the indices buffered for
+modifiers that were not handed out yet */
+template <typename T>
+void streamRegister_t<T>::saveState(stateWriter_t &w) const {
+    w.put<std::uint8_t>(std::uint8_t(type));
+    w.put<std::uint8_t>(std::uint8_t(status));
+    w.put<std::uint8_t>(std::uint8_t(mode));
+    w.put<std::uint8_t>(std::uint8_t(predMode));
+    w.put<std::uint16_t>(validElements);
+    w.putBytes(elements.data(), vLen * elementWidth);
+    descriptor.saveState(w);
+
+    w.put<std::uint16_t>(indexCount - indexNext);
+    w.putBytes(&indexBuffer[indexNext], (indexCount - indexNext) * elementWidth);
+    w.put<std::uint8_t>(fillInterrupted);
+    w.put<std::uint16_t>(fillProgress);
+    w.put<std::uint8_t>(iterationPending);
+    w.put<std::uint8_t>(fillComplete);
+}
+
+template <typename T>
+void streamRegister_t<T>::restoreState(stateReader_t &r) {
+    type = r.getEnum<RegisterConfig>(4);
+    status = r.getEnum<RegisterStatus>(3);
+    mode = r.getEnum<RegisterMode>(2);
+    predMode = r.getEnum<PredicateMode>(2);
+    validElements = r.getCount<std::uint16_t>(vLen);
+    r.getBytes(elements.data(), vLen * elementWidth);
+    descriptor.restoreState(r, su);
+
+    indexNext = 0;
+    indexCount = r.getCount<std::uint16_t>(maxVLen);
+    r.getBytes(indexBuffer.data(), indexCount * elementWidth);
+    fillInterrupted = r.get<std::uint8_t>();
+    fillProgress = r.getCount<std::uint16_t>(vLen);
+    iterationPending = r.get<std::uint8_t>();
+    fillComplete = r.get<std::uint8_t>();
+}
+
+template <typename T>
+bool streamRegister_t<T>::isIdle() const {
+    return type == RegisterConfig::NoStream && status == RegisterStatus::NotConfigured && mode == RegisterMode::Vector &&
+           predMode == PredicateMode::Zeroing && validElements == 0 && indexNext == indexCount && !fillInterrupted &&
+           !iterationPending && descriptor.isEmpty() &&
+           std::all_of(elements.begin(), elements.begin() + vLen, [](T e) { return e == 0; });
+}
+
+predRegister_t::MaskType predRegister_t::getPredicate() const {
+    return mask;
+}
+
+/* Reverses the order of the first n flags, leaving the others untouched */
+predRegister_t::MaskType predRegister_t::reverse(const MaskType &m, size_t n) {
+    if (n == 0)
+        return m;
+    /* Bit-reverse every word and the order of the words, then bring the
+    first n flags back to the bottom */
+    MaskType r;
+    for (size_t i = 0; i < MaskType::wordCount; i++) {
+        std::uint64_t w = m.words[i];
+        w = ((w >> 1) & 0x5555555555555555) | ((w & 0x5555555555555555) << 1);
+        w = ((w >> 2) & 0x3333333333333333) | ((w & 0x3333333333333333) << 2);
+        w = ((w >> 4) & 0x0f0f0f0f0f0f0f0f) | ((w & 0x0f0f0f0f0f0f0f0f) << 4);
+        w = ((w >> 8) & 0x00ff00ff00ff00ff) | ((w & 0x00ff00ff00ff00ff) << 8);
+        w = ((w >> 16) & 0x0000ffff0000ffff) | ((w & 0x0000ffff0000ffff) << 16);
+        r.words[MaskType::wordCount - 1 - i] = (w >> 32) | (w << 32);
+    }
+    const MaskType low = firstElements(n, 1);
+    return ((r >> (maxVLen - n)) & low) | (m & ~low);
 }
 
 PredicateMode predRegister_t::getPredMode() const {
@@ -522,41 +728,306 @@ void predRegister_t::setPredMode(const PredicateMode pm) {
     predMode = pm;
 }
 
-void streamingUnit_t::updateEODTable(const size_t stream) {
-    int r = 0, d = 0;
-    std::visit([&](const auto reg) {
-        int d = 0;
-        for (const auto dim : reg.dimensions) {
-            EODTable.at(stream).at(d) = dim.isEndOfDimension();
-            ++d;
-        }
-    },
-               registers.at(stream));
+void streamingUnit_t::updateEODTable(const size_t stream, const uint8_t eodMask, const size_t dimensionCount) {
+    // Flags of dimensions the stream does not have keep their previous value
+    const uint8_t valid = (1u << dimensionCount) - 1;
+    EODTable.at(stream) = (EODTable.at(stream) & ~valid) | (eodMask & valid);
 }
 
 template <typename T>
 void streamingUnit_t::makeStreamRegister(size_t streamRegister, RegisterConfig type, PredicateMode pm) {
     assert_msg("Tried to use a register index higher than the available registers", streamRegister < registerCount);
+    if (auto pc = configuringPCs.at(streamRegister))
+        operateRegister(streamRegister, [&](auto &reg) {
+            cachedDescriptor(*pc) = {pc, std::move(reg.descriptor)};
+        });
+
     if constexpr (std::is_same_v<T, std::uint8_t>) {
-        registers.at(streamRegister) = StreamReg8{this, pm, type, streamRegister};
+        registers.at(streamRegister) = StreamReg8{this, pm, type, streamRegister, registerLength};
     } else if constexpr (std::is_same_v<T, std::uint16_t>) {
-        registers.at(streamRegister) = StreamReg16{this, pm, type, streamRegister};
+        registers.at(streamRegister) = StreamReg16{this, pm, type, streamRegister, registerLength};
     } else if constexpr (std::is_same_v<T, std::uint32_t>) {
-        registers.at(streamRegister) = StreamReg32{this, pm, type, streamRegister};
+        registers.at(streamRegister) = StreamReg32{this, pm, type, streamRegister, registerLength};
     } else if constexpr (std::is_same_v<T, std::uint64_t>) {
-        registers.at(streamRegister) = StreamReg64{this, pm, type, streamRegister};
+        registers.at(streamRegister) = StreamReg64{this, pm, type, streamRegister, registerLength};
     } else {
         static_assert(always_false_v<T>, "Cannot create register with this element width");
     }
+    widthTags.at(streamRegister) = sizeof(T);
+    configurations.at(streamRegister) = nullptr;
+    configuringPCs.at(streamRegister).reset();
+    if (type == RegisterConfig::NoStream || !p)
+        return;
+
+    const std::uint64_t pc = p->get_state()->pc;
+    configurations.at(streamRegister) = &configurationStats[pc];
+    configuringPCs.at(streamRegister) = pc;
+    cachedDescriptor_t &cached = cachedDescriptor(pc);
+    if (cached.pc == pc) {
+        std::get<streamRegister_t<T>>(registers.at(streamRegister)).descriptor = std::move(cached.descriptor);
+        cached.pc.reset();
+    }
 }
 
-void streamingUnit_t::makePredRegister(std::vector<uint8_t> elements, size_t predRegister, PredicateMode pm) {
+void streamingUnit_t::makePredRegister(predRegister_t::MaskType mask, size_t predRegister, PredicateMode pm) {
     assert_msg("Tried to alter p0 register, which is hardwired to 1", predRegister);
     assert_msg("Tried to use a predicate register index higher than the available predicate registers", predRegister < predRegCount);
-    assert_msg("Tried to create predicate with invalid size", elements.size() == predicates.at(predRegister).vLen);
-    for (auto &p : elements)
-        assert_msg("Invalid values for predicate (must be 0 or 1)", !p || p == 1);
-    predicates.at(predRegister) = predRegister_t{elements, pm};
+    predicates.at(predRegister) = predRegister_t{mask, pm};
+    if (p && p->get_log_commits_enabled())
+        p->get_state()->log_reg_write[(predRegister << 4) | 6] = {0, 0};
+}
+
+streamStats_t &streamStats_t::operator+=(const streamStats_t &other) {
+    loadedElements += other.loadedElements;
+    storedElements += other.storedElements;
+    loadedBytes += other.loadedBytes;
+    storedBytes += other.storedBytes;
+    fills += other.fills;
+    validElements += other.validElements;
+    lanes += other.lanes;
+    for (size_t i = 0; i < endOfDimension.size(); i++)
+        endOfDimension[i] += other.endOfDimension[i];
+    modifierApplications += other.modifierApplications;
+    indexFetches += other.indexFetches;
+    stallCycles += other.stallCycles;
+    return *this;
+}
+
+void streamingUnit_t::recordAccess(size_t stream, const streamStats_t &access) {
+    registerStats.at(stream) += access;
+    if (streamStats_t *configuration = configurations.at(stream))
+        *configuration += access;
+}
+
+std::uint64_t streamingUnit_t::readEvent(std::uint64_t event) const {
+    streamStats_t total;
+    for (const auto &stats : registerStats)
+        total += stats;
+
+    switch (uveEvent(event)) {
+    case uveEvent::LoadedElements:
+        return total.loadedElements;
+    case uveEvent::StoredElements:
+        return total.storedElements;
+    case uveEvent::LoadedBytes:
+        return total.loadedBytes;
+    case uveEvent::StoredBytes:
+        return total.storedBytes;
+    case uveEvent::Fills:
+        return total.fills;
+    case uveEvent::ValidElements:
+        return total.validElements;
+    case uveEvent::Lanes:
+        return total.lanes;
+    case uveEvent::EndOfDimension: {
+        std::uint64_t events = 0;
+        for (auto count : total.endOfDimension)
+            events += count;
+        return events;
+    }
+    case uveEvent::ModifierApplications:
+        return total.modifierApplications;
+    case uveEvent::IndexFetches:
+        return total.indexFetches;
+    case uveEvent::StallCycles:
+        return total.stallCycles;
+    case uveEvent::ConfigurationHits:
+        return configurationHits;
+    case uveEvent::ConfigurationMisses:
+        return configurationMisses;
+    default:
+        return 0;
+    }
+}
+
+static void dumpStreamStats(FILE *out, const streamStats_t &stats) {
+    fprintf(out, "\"loaded_elements\": %" PRIu64 ", \"stored_elements\": %" PRIu64 ", ", stats.loadedElements, stats.storedElements);
+    fprintf(out, "\"loaded_bytes\": %" PRIu64 ", \"stored_bytes\": %" PRIu64 ", ", stats.loadedBytes, stats.storedBytes);
+    fprintf(out, "\"fills\": %" PRIu64 ", \"valid_elements\": %" PRIu64 ", \"lanes\": %" PRIu64 ", ", stats.fills, stats.validElements, stats.lanes);
+    fprintf(out, "\"avg_valid_elements\": %.3f, \"lane_utilisation\": %.3f, ",
+            stats.fills ? double(stats.validElements) / stats.fills : 0.0,
+            stats.lanes ? double(stats.validElements) / stats.lanes : 0.0);
+    fprintf(out, "\"eod_events\": [");
+    for (size_t i = 0; i < stats.endOfDimension.size(); i++)
+        fprintf(out, "%s%" PRIu64, i ? ", " : "", stats.endOfDimension[i]);
+    fprintf(out, "], \"modifier_applications\": %" PRIu64 ", \"index_fetches\": %" PRIu64 ", \"stall_cycles\": %" PRIu64,
+            stats.modifierApplications, stats.indexFetches, stats.stallCycles);
+}
+
+void streamingUnit_t::dumpStats(FILE *out) const {
+    fprintf(out, "{\"register_length\": %zu, ", registerLength);
+    fprintf(out, "\"configuration_cache\": {\"hits\": %" PRIu64 ", \"misses\": %" PRIu64 "}, ", configurationHits, configurationMisses);
+    fprintf(out, "\"streams\": [");
+    bool first = true;
+    for (size_t i = 0; i < registerCount; i++) {
+        if (!registerStats[i].fills)
+            continue;
+        fprintf(out, "%s\n      {\"register\": %zu, ", first ? "" : ",", i);
+        dumpStreamStats(out, registerStats[i]);
+        fprintf(out, "}");
+        first = false;
+    }
+    fprintf(out, "],\n    \"configurations\": [");
+    first = true;
+    for (const auto &[pc, stats] : configurationStats) {
+        fprintf(out, "%s\n      {\"pc\": \"0x%" PRIx64 "\", ", first ? "" : ",", pc);
+        dumpStreamStats(out, stats);
+        fprintf(out, "}");
+        first = false;
+    }
+    fprintf(out, "]}");
+}
+
+void streamingUnit_t::enableTiming(size_t fifoDepth, size_t bandwidth, size_t latency) {
+    assert_msg("The timing model needs a FIFO and a memory port", fifoDepth && bandwidth);
+    timing.emplace(registerCount, fifoDepth, bandwidth, latency);
+}
+
+void streamingUnit_t::setRegisterLength(size_t length) {
+    assert_msg("Unsupported register length", length >= minRegisterLength && length <= maxRegisterLength && !(length & (length - 1)));
+    registerLength = length;
+    for (size_t i = 0; i < registerCount; i++)
+        makeStreamRegister<std::uint8_t>(i);
+}
+
+bool streamingUnit_t::isIdle(size_t streamRegister) const {
+    return widthTags[streamRegister] == StreamReg8::elementWidth && EODTable[streamRegister] == 0 &&
+           std::get<StreamReg8>(registers[streamRegister]).isIdle();
+}
+
+void streamingUnit_t::reset() {
+    for (size_t i = 0; i < registerCount; i++)
+        if (!isIdle(i))
+            makeStreamRegister<std::uint8_t>(i);
+    EODTable.fill(0);
+    for (size_t i = 0; i < predRegCount; i++)
+        predicates[i] = resetPredicate(i);
+    instructionPC = replayPC = 0;
+    instructionFills = replayFills = 0;
+}
+
+/* Saved state starts with a header:
+    magic, version, register length
+    mask of the registers saved, mask of the predicates saved
+    registers the instruction to retry already accessed, and its PC if any
+followed by each register saved, as its element width, EOD flags and
+streamRegister_t::saveState, and then by each predicate saved, as its mode and
+mask */
+static constexpr std::uint32_t stateMagic = 0x53455655; // "UVES"
+
+void streamingUnit_t::saveState(std::vector<std::uint8_t> &out) const {
+    std::uint32_t registerMask = 0;
+    for (size_t i = 0; i < registerCount; i++)
+        registerMask |= std::uint32_t(!isIdle(i)) << i;
+    std::uint16_t predicateMask = 0;
+    for (size_t i = 0; i < predRegCount; i++) {
+        const predRegister_t initial = resetPredicate(i);
+        predicateMask |= std::uint16_t(predicates[i].mask != initial.mask || predicates[i].predMode != initial.predMode) << i;
+    }
+
+    stateWriter_t w{out};
+    w.put<std::uint32_t>(stateMagic);
+    w.put<std::uint16_t>(stateVersion);
+    w.put<std::uint16_t>(registerLength);
+    w.put<std::uint32_t>(registerMask);
+    w.put<std::uint16_t>(predicateMask);
+    w.put<std::uint32_t>(replayFills);
+    if (replayFills)
+        w.put<std::uint64_t>(replayPC);
+
+    for (size_t i = 0; i < registerCount; i++) {
+        if (!((registerMask >> i) & 1))
+            continue;
+        w.put<std::uint8_t>(widthTags[i]);
+        w.put<std::uint8_t>(EODTable[i]);
+        std::visit([&](auto &reg) { reg.saveState(w); }, registers[i]);
+    }
+    for (size_t i = 0; i < predRegCount; i++) {
+        if (!((predicateMask >> i) & 1))
+            continue;
+        w.put<std::uint8_t>(std::uint8_t(predicates[i].predMode));
+        w.putBytes(predicates[i].mask.words.data(), sizeof(predicates[i].mask.words));
+    }
+}
+
+size_t streamingUnit_t::restoreState(std::span<const std::uint8_t> in) {
+    stateReader_t r{in};
+    r.check(r.get<std::uint32_t>() == stateMagic);
+    r.check(r.get<std::uint16_t>() == stateVersion);
+    r.check(r.get<std::uint16_t>() == registerLength);
+    const std::uint32_t registerMask = r.get<std::uint32_t>();
+    const std::uint16_t predicateMask = r.get<std::uint16_t>();
+    const std::uint32_t fills = r.get<std::uint32_t>();
+    const std::uint64_t fillsPC = fills ? r.get<std::uint64_t>() : 0;
+    if (r.failed) {
+        reset();
+        return 0;
+    }
+
+    reset();
+    replayFills = fills;
+    replayPC = fillsPC;
+    for (size_t i = 0; i < registerCount && !r.failed; i++) {
+        if (!((registerMask >> i) & 1))
+            continue;
+        switch (r.get<std::uint8_t>()) {
+        case sizeof(std::uint8_t):
+            makeStreamRegister<std::uint8_t>(i);
+            break;
+        case sizeof(std::uint16_t):
+            makeStreamRegister<std::uint16_t>(i);
+            break;
+        case sizeof(std::uint32_t):
+            makeStreamRegister<std::uint32_t>(i);
+            break;
+        case sizeof(std::uint64_t):
+            makeStreamRegister<std::uint64_t>(i);
+            break;
+        default:
+            r.check(false);
+        }
+        EODTable[i] = r.get<std::uint8_t>();
+        operateRegister(i, [&](auto &reg) { reg.restoreState(r); });
+        // The engine fetches restored streams from scratch
+        if (timing)
+            timing->configure(i);
+    }
+    for (size_t i = 0; i < predRegCount && !r.failed; i++) {
+        if (!((predicateMask >> i) & 1))
+            continue;
+        predicates[i].predMode = r.getEnum<PredicateMode>(2);
+        r.getBytes(predicates[i].mask.words.data(), sizeof(predicates[i].mask.words));
+    }
+
+    if (r.failed) {
+        reset();
+        return 0;
+    }
+    return r.position;
+}
+
+void streamingUnit_t::configureLike(size_t streamRegister, size_t src) {
+    configureWithWidth(streamRegister, widthTags.at(src));
+}
+
+void streamingUnit_t::configureWithWidth(size_t streamRegister, size_t width) {
+    if (operateRegister(streamRegister, [](auto &reg) { return reg.getStatus(); }) != RegisterStatus::NotConfigured)
+        return;
+
+    switch (width) {
+    case sizeof(std::uint8_t):
+        makeStreamRegister<std::uint8_t>(streamRegister);
+        break;
+    case sizeof(std::uint16_t):
+        makeStreamRegister<std::uint16_t>(streamRegister);
+        break;
+    case sizeof(std::uint32_t):
+        makeStreamRegister<std::uint32_t>(streamRegister);
+        break;
+    default:
+        makeStreamRegister<std::uint64_t>(streamRegister);
+    }
+    operateRegister(streamRegister, [](auto &reg) { reg.endConfiguration(); });
 }
 
 template class streamRegister_t<uint8_t>;
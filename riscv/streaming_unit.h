@@ -3,6 +3,11 @@
 
 #include "descriptors.h"
 #include "helpers.h"
+#include "streaming_state.h"
+#include "streaming_timing.h"
+#include <cstdio>
+#include <map>
+#include <optional>
 
 /* Necessary for using MMU */
 class processor_t;
@@ -24,6 +29,85 @@ enum class RegisterMode { Vector,
 enum class PredicateMode { Zeroing,
                            Merging };   
 
+/* Register lengths, in bytes, the streaming unit can be configured with through
+--uve-vlen. The gem5 implementation was made with 64 bytes, so the default
+mirrors it. Lengths are powers of 2, with at least 8 bytes to support the
+64-bit operations */
+static constexpr size_t minRegisterLength = 16;
+static constexpr size_t maxRegisterLength = 256;
+static constexpr size_t defaultRegisterLength = 64;
+
+/* Formats 16-bit floating-point elements are operated on as, picked for the
+whole unit through --uve-fp16 */
+enum class Fp16Format { Half,
+                        BFloat16 };
+
+/* OCP formats 8-bit floating-point elements are read as by the widening
+instructions, picked through --uve-fp8 */
+enum class Fp8Format { E4M3,
+                       E5M2 };
+
+/* Calls f with the given register length as a std::integral_constant, so that
+code specialised for each supported length is picked at run time */
+template <typename F>
+decltype(auto) withRegisterLength(const size_t length, F &&f) {
+    switch (length) {
+    case 16:
+        return f(std::integral_constant<size_t, 16>{});
+    case 32:
+        return f(std::integral_constant<size_t, 32>{});
+    case 64:
+        return f(std::integral_constant<size_t, 64>{});
+    case 128:
+        return f(std::integral_constant<size_t, 128>{});
+    default:
+        return f(std::integral_constant<size_t, maxRegisterLength>{});
+    }
+}
+
+/* --- Stream Counters --- */
+
+/* Activity of the streams held by a stream register, or configured by the
+instruction at a given PC */
+struct streamStats_t {
+    std::uint64_t loadedElements = 0;
+    std::uint64_t storedElements = 0;
+    std::uint64_t loadedBytes = 0;
+    std::uint64_t storedBytes = 0;
+    /* Register loads or stores, and the valid elements and lanes over all of
+    them. Lanes are the elements an access could have moved, vLen in vector
+    mode and 1 in scalar mode */
+    std::uint64_t fills = 0;
+    std::uint64_t validElements = 0;
+    std::uint64_t lanes = 0;
+    /* Accesses that left each dimension with its EOD flag set */
+    std::array<std::uint64_t, descriptorIterator_t::maxDimensions> endOfDimension{};
+    std::uint64_t modifierApplications = 0;
+    std::uint64_t indexFetches = 0;
+    /* Estimated by the timing model, when enabled */
+    std::uint64_t stallCycles = 0;
+
+    streamStats_t &operator+=(const streamStats_t &other);
+};
+
+/* Streaming unit events that can be selected in the mhpmevent CSRs. Counts
+are totals over every stream register of the hart */
+enum class uveEvent : std::uint64_t { None,
+                                      LoadedElements,
+                                      StoredElements,
+                                      LoadedBytes,
+                                      StoredBytes,
+                                      Fills,
+                                      ValidElements,
+                                      Lanes,
+                                      EndOfDimension,
+                                      ModifierApplications,
+                                      IndexFetches,
+                                      StallCycles,
+                                      ConfigurationHits,
+                                      ConfigurationMisses,
+                                      Count };
+
 /* --- Streaming Registers --- */
 
 /* T is one of std::uint8_t, std::uint16_t, std::uint32_t or std::uint64_t and
@@ -32,17 +116,15 @@ enum class PredicateMode { Zeroing,
 template <typename T>
 struct streamRegister_t {
     using ElementsType = T;
-    /* The gem5 implementation was made with 64 bytes, so this value mirrors it.
-    It can be changed to another value that is a power of 2, with atleast 8 bytes
-    to support at the 64-bit operations */
-    static constexpr size_t registerLength = 64; // in Bytes
-    //static constexpr size_t registerLength = 16; // in Bytes
     /* During computations, we test if two streams have the same element width
     using this property */
     static constexpr size_t elementWidth = sizeof(ElementsType);
-    /* This property limits how many elements can be manipulated during a
-    computation and also how many can be loaded/stored at a time */
-    static constexpr size_t vLen = registerLength / elementWidth;
+    /* Elements held by a register of the longest supported length */
+    static constexpr size_t maxVLen = maxRegisterLength / elementWidth;
+    /* Register contents are held inline, so copying them out or building a
+    result to be written back never touches the heap. Only the first vLen
+    elements are in use */
+    using ElementsStorage = std::array<ElementsType, maxVLen>;
 
     /* In this implementation, the concept of a stream and register are heavily
     intertwined. As such, stream attributes, such as dimensions, modifiers, EOD flags,
@@ -60,13 +142,11 @@ struct streamRegister_t {
     /* FOR DEBUGGING */
     size_t registerN;
 
-    streamRegister_t(streamingUnit_t *su = nullptr, PredicateMode pm = PredicateMode::Zeroing, RegisterConfig t = RegisterConfig::NoStream, size_t regN = -1) :
-     registerN(regN), su(su), predMode(pm), type(t) {
+    streamRegister_t(streamingUnit_t *su = nullptr, PredicateMode pm = PredicateMode::Zeroing, RegisterConfig t = RegisterConfig::NoStream, size_t regN = -1, size_t length = defaultRegisterLength) :
+     registerN(regN), su(su), vLen(length / elementWidth), predMode(pm), type(t) {
         status = RegisterStatus::NotConfigured;
         mode = RegisterMode::Vector;
         validElements = 0;
-        vecCfgDim = 0;
-        baseAddress = 0;
     }
 
     void addStaticModifier(staticModifier_t mod);
@@ -77,9 +157,18 @@ struct streamRegister_t {
     void startConfiguration(size_t base_address);
     void endConfiguration();
     void finishStream();
-    std::vector<ElementsType> getElements(bool causesUpdate = true);
+    ElementsStorage getElements(bool causesUpdate = true);
+    /* Same as getElements, without copying the register contents out */
+    std::span<const ElementsType, maxVLen> readElements(bool causesUpdate = true);
+    std::span<ElementsType, maxVLen> getElementsView();
+    /* Next index for a dynamic or scatter-gather modifier fed by this stream.
+    Returns false once the index returned is the last one of the stream */
     bool getDynModElement(int &value);
-    void setElements(std::vector<ElementsType> e, bool causesUpdate = true);
+    /* Makes sure n indices can be handed out to modifiers without touching
+    memory. Fetching them may trap, which a modifier must not do halfway
+    through an iteration update */
+    void reserveIndices(size_t n);
+    void setElements(std::span<const ElementsType> e, bool causesUpdate = true);
     void setValidIndex(const size_t i);
     void setMode(const RegisterMode m);
     void setPredMode(const PredicateMode pm);
@@ -99,62 +188,192 @@ struct streamRegister_t {
     /* FOR DEBUGGING*/
     void printRegN(char *str = "");
 
+    /* Saved state of the register, see streamingUnit_t::saveState */
+    void saveState(stateWriter_t &w) const;
+    void restoreState(stateReader_t &r);
+    /* Whether the register is still as made on reset */
+    bool isIdle() const;
+
     friend class streamingUnit_t;
 
 private:
     streamingUnit_t *su;
-    std::vector<ElementsType> elements = std::vector<ElementsType>(vLen);
+    ElementsStorage elements{};
+    /* This property limits how many elements can be manipulated during a
+    computation and also how many can be loaded/stored at a time */
+    size_t vLen;
     size_t validElements;
-    /* Same ordeal as above. Although the amount of dimensions is capped, we can avoid
-    indexing by just calling the size method */
-    std::deque<dimension_t> dimensions;
-    /* Modifiers are different in that they don't have to scale linearly in a stream
-    configuration. As such, it is better to have a container that maps a dimension's
-    index to its modifier. When updating stream the iterators, we can test if a dimension
-    for the given index exists before the calculations */
-    std::unordered_multimap<int, staticModifier_t> staticModifiers;
-    std::unordered_multimap<int, dynamicModifier_t> dynamicModifiers;
-    std::unordered_multimap<int, scatterGModifier_t> scatterGModifiers;
+    /* Dimensions and modifiers of the stream, lowered into a flat iterator as
+    they are configured */
+    descriptorIterator_t descriptor;
+    /* Indices fetched ahead by a scalar source of modifiers, one per fetch the
+    modifiers would have made themselves, consumed from indexNext onwards */
+    ElementsStorage indexBuffer{};
+    size_t indexCount = 0;
+    size_t indexNext = 0;
+    /* Progress of a fill cut short by a trap, resumed by the next one */
+    bool fillInterrupted = false;
+    size_t fillProgress = 0;
+    /* The iteration update that follows the last element moved trapped */
+    bool iterationPending = false;
+    /* The elements of the current fill have all been moved */
+    bool fillComplete = false;
     PredicateMode predMode;
     RegisterConfig type;
     RegisterStatus status;
     RegisterMode mode;
 
-    int vecCfgDim;
-
-    size_t baseAddress;
-
-    size_t generateAddress();
-    bool isDimensionFullyDone(const std::deque<dimension_t>::const_iterator start, const std::deque<dimension_t>::const_iterator end) const;
     bool isStreamDone() const;
     bool tryGenerateAddress(size_t &address);
-    void applySGMods(size_t dimN);
-    void setDynamicModsNotApplied(size_t dimN);
-    void setSGModsNotApplied(size_t dimN);
     void updateIteration();
+    /* Marks the register as written by the current instruction in the commit log */
+    void logWrite() const;
+    ElementsType loadElement(size_t address);
+    /* Fill or drain of the register by the current instruction */
+    void update();
+    void finishPendingIteration();
     void updateAsLoad();
     void updateAsStore();
+    void fetchIndices();
+    void recordAccess(bool isLoad, size_t elements, size_t lanes);
 };
 
 /* --- Predicate Registers --- */
 
+/* Flags of a predicate register, one per byte of the longest supported
+register. Behaves as an unsigned integer of that many bits, built from the
+64-bit words it is stored in */
+struct predMask_t {
+    static constexpr size_t wordBits = 64;
+    static constexpr size_t wordCount = maxRegisterLength / wordBits;
+    std::array<std::uint64_t, wordCount> words{};
+
+    constexpr predMask_t() = default;
+    constexpr predMask_t(std::uint64_t low) : words{low} {}
+
+    /* Word i of a mask with its lowest n flags set */
+    static constexpr std::uint64_t lowWord(size_t n, size_t i) {
+        return n >= (i + 1) * wordBits ? ~std::uint64_t(0) : n <= i * wordBits ? 0 : (std::uint64_t(1) << (n - i * wordBits)) - 1;
+    }
+
+    constexpr bool test(size_t bit) const {
+        return bit < wordCount * wordBits && ((words[bit / wordBits] >> (bit % wordBits)) & 1);
+    }
+
+    constexpr predMask_t operator~() const {
+        predMask_t r;
+        for (size_t i = 0; i < wordCount; i++)
+            r.words[i] = ~words[i];
+        return r;
+    }
+
+    constexpr predMask_t &operator&=(const predMask_t &o) {
+        for (size_t i = 0; i < wordCount; i++)
+            words[i] &= o.words[i];
+        return *this;
+    }
+
+    constexpr predMask_t &operator|=(const predMask_t &o) {
+        for (size_t i = 0; i < wordCount; i++)
+            words[i] |= o.words[i];
+        return *this;
+    }
+
+    constexpr predMask_t &operator^=(const predMask_t &o) {
+        for (size_t i = 0; i < wordCount; i++)
+            words[i] ^= o.words[i];
+        return *this;
+    }
+
+    constexpr predMask_t operator<<(size_t s) const {
+        predMask_t r;
+        const size_t w = s / wordBits, b = s % wordBits;
+        for (size_t i = w; i < wordCount; i++) {
+            r.words[i] = words[i - w] << b;
+            if (b && i > w)
+                r.words[i] |= words[i - w - 1] >> (wordBits - b);
+        }
+        return r;
+    }
+
+    constexpr predMask_t operator>>(size_t s) const {
+        predMask_t r;
+        const size_t w = s / wordBits, b = s % wordBits;
+        for (size_t i = 0; i + w < wordCount; i++) {
+            r.words[i] = words[i + w] >> b;
+            if (b && i + w + 1 < wordCount)
+                r.words[i] |= words[i + w + 1] << (wordBits - b);
+        }
+        return r;
+    }
+
+    friend constexpr predMask_t operator&(predMask_t a, const predMask_t &b) { return a &= b; }
+    friend constexpr predMask_t operator|(predMask_t a, const predMask_t &b) { return a |= b; }
+    friend constexpr predMask_t operator^(predMask_t a, const predMask_t &b) { return a ^= b; }
+    friend constexpr bool operator==(const predMask_t &a, const predMask_t &b) = default;
+};
+
+/* A predicate holds one flag per byte of a streaming register, packed in a
+mask where bit b is the flag of byte b. Element i of a stream with elements of
+w bytes is active when the flag of its last byte, (i + 1) * w - 1, is set */
 struct predRegister_t {
-    static constexpr size_t registerLength = 64; // in Bytes
     static constexpr size_t elementWidth = sizeof(uint8_t);
-    static constexpr size_t vLen = registerLength / elementWidth;
+    static constexpr size_t maxVLen = maxRegisterLength / elementWidth;
+    using MaskType = predMask_t;
 
-    predRegister_t(std::vector<uint8_t> e = std::vector<uint8_t>(vLen), PredicateMode pm = PredicateMode::Merging) {
-        elements = e;
-        predMode = pm;
-    }
+    predRegister_t(MaskType m = 0, PredicateMode pm = PredicateMode::Merging) : mask(m), predMode(pm) {}
+
+    MaskType getPredicate() const;
 
-    std::vector<uint8_t> getPredicate() const;
+    bool isElementActive(size_t i, size_t width) const {
+        return isElementActive(mask, i, width);
+    }
 
     PredicateMode getPredMode() const;
     void setPredMode(const PredicateMode pm);
 
+    static constexpr bool isElementActive(const MaskType &m, size_t i, size_t width) {
+        return m.test((i + 1) * width - 1);
+    }
+
+    /* Flags of every byte of the first n elements */
+    static constexpr MaskType firstElements(size_t n, size_t width) {
+        MaskType r;
+        for (size_t i = 0; i < MaskType::wordCount; i++)
+            r.words[i] = MaskType::lowWord(n * width, i);
+        return r;
+    }
+
+    /* Flag of the last byte of every element. Elements never straddle two
+    words, so every word holds the same pattern */
+    static constexpr MaskType lastBytes(size_t width) {
+        MaskType r;
+        r.words.fill(~std::uint64_t(0) / ((std::uint64_t(1) << width) - 1) << (width - 1));
+        return r;
+    }
+
+    /* Copies the flag of the last byte of every element to all its bytes */
+    static constexpr MaskType fillElements(const MaskType &m, size_t width) {
+        const MaskType last = m & lastBytes(width);
+        MaskType r;
+        for (size_t i = 0; i < MaskType::wordCount; i++)
+            r.words[i] = (last.words[i] >> (width - 1)) * ((std::uint64_t(1) << width) - 1);
+        return r;
+    }
+
+    /* Takes the flags of value for the elements active in pred and the ones
+    of dest for the others */
+    static constexpr MaskType merge(const MaskType &value, const MaskType &dest, const MaskType &pred, size_t width = elementWidth) {
+        const MaskType active = fillElements(pred, width);
+        return (value & active) | (dest & ~active);
+    }
+
+    /* Reverses the order of the first n flags, n being the register length
+    the predicate is used with */
+    static MaskType reverse(const MaskType &m, size_t n);
+
 private:
-    std::vector<uint8_t> elements = std::vector<uint8_t>(vLen);
+    MaskType mask;
 
     PredicateMode predMode;
 
@@ -173,7 +392,7 @@ struct streamingUnit_t {
     /* UVE specification is to have 32 streaming/vectorial registers */
     static constexpr size_t registerCount = 32;
     static constexpr size_t predRegCount = 16;
-    static constexpr size_t maxDimensions = 8;
+    static constexpr size_t maxDimensions = descriptorIterator_t::maxDimensions;
     /* There are 2 types at play when implementing the UVE specification. A storage
     type, which is how values get stored, and a computation type, the type a value
     should have when doing computations. Using a variant allows us to have almost
@@ -182,21 +401,161 @@ struct streamingUnit_t {
     a raw cast to a signed or floating-point value.  */
     using RegisterType = std::variant<StreamReg8, StreamReg16, StreamReg32, StreamReg64>;
 
-    std::array<std::array<bool, maxDimensions>, registerCount> EODTable;
+    /* EOD flags of each stream as left by its last access, which is what
+    branches test. Bit d holds the flag of dimension d */
+    std::array<uint8_t, registerCount> EODTable{};
 
     std::array<RegisterType, registerCount> registers;
     std::array<predRegister_t, predRegCount> predicates;
 
+    /* Element width, in bytes, of the register held by each stream register.
+    Instructions resolve the element type of their operands from it once,
+    instead of visiting every combination of their variants */
+    std::array<uint8_t, registerCount> widthTags;
+
     streamingUnit_t() {
-        predicates.at(0).elements = std::vector<uint8_t>(predicates.at(0).vLen, 1);
+        predicates.at(0) = resetPredicate(0);
+        widthTags.fill(StreamReg8::elementWidth);
+    }
+
+    /* Length, in bytes, of every stream register. Changing it resets them */
+    void setRegisterLength(size_t length);
+
+    size_t getRegisterLength() const {
+        return registerLength;
+    }
+
+    void setFp16Format(Fp16Format format) {
+        fp16Format = format;
+    }
+
+    Fp16Format getFp16Format() const {
+        return fp16Format;
+    }
+
+    void setFp8Format(Fp8Format format) {
+        fp8Format = format;
+    }
+
+    Fp8Format getFp8Format() const {
+        return fp8Format;
     }
 
     template <typename T>
     void makeStreamRegister(size_t streamRegister, RegisterConfig type = RegisterConfig::NoStream, PredicateMode pm = PredicateMode::Zeroing);
 
-    void makePredRegister(std::vector<uint8_t> elements, size_t predRegister, PredicateMode pm = PredicateMode::Merging);
+    void makePredRegister(predRegister_t::MaskType mask, size_t predRegister, PredicateMode pm = PredicateMode::Merging);
+
+    /* Gives an unconfigured register the element width of src, so that an
+    operation writing to it finds operands of matching widths */
+    void configureLike(size_t streamRegister, size_t src);
+    /* Same, with elements of the given width, for operations changing it */
+    void configureWithWidth(size_t streamRegister, size_t width);
+
+    /* Calls handler with the given stream registers as their width-specialised
+    type. All of them must have the same element width, and handler only needs
+    overloads for the widths the instruction supports */
+    template <typename Handler, typename... Indices>
+    void dispatchByWidth(Handler &&handler, Indices... streamRegisters) {
+        const std::array<size_t, sizeof...(Indices)> indices{size_t(streamRegisters)...};
+        const uint8_t width = widthTags.at(indices[0]);
+        assert_msg("Given vectors have different widths", ((widthTags.at(streamRegisters) == width) && ...));
+        switch (width) {
+        case sizeof(std::uint8_t):
+            return invokeWithWidth<std::uint8_t>(handler, streamRegisters...);
+        case sizeof(std::uint16_t):
+            return invokeWithWidth<std::uint16_t>(handler, streamRegisters...);
+        case sizeof(std::uint32_t):
+            return invokeWithWidth<std::uint32_t>(handler, streamRegisters...);
+        default:
+            return invokeWithWidth<std::uint64_t>(handler, streamRegisters...);
+        }
+    }
+
+    void updateEODTable(const size_t stream, const uint8_t eodMask, const size_t dimensionCount);
+
+    /* Counters of every stream register and of every configuring PC */
+    std::array<streamStats_t, registerCount> registerStats;
+    std::map<std::uint64_t, streamStats_t> configurationStats;
+
+    void recordAccess(size_t stream, const streamStats_t &access);
+
+    /* Stream configurations that reused the shape of the descriptor cached
+    for their configuring PC, and the ones that had to lower it again */
+    std::uint64_t configurationHits = 0;
+    std::uint64_t configurationMisses = 0;
+
+    /* Stream accesses are restartable. A fill that traps keeps the elements
+    it already moved and resumes from the faulting one. The registers the
+    trapping instruction had already filled or drained hand their contents out
+    again when it is retried (the next instruction at the same PC), instead of
+    advancing their streams. An instruction reading the same stream twice is
+    the exception, as its second fill overwrites the first one */
+    void beginInstruction(std::uint64_t pc) {
+        instructionPC = pc;
+        instructionFills = 0;
+    }
+
+    void recordFill(size_t stream) {
+        instructionFills |= std::uint32_t(1) << stream;
+    }
+
+    void abortInstruction() {
+        replayPC = instructionPC;
+        replayFills = instructionFills;
+    }
+
+    bool takeReplay(size_t stream) {
+        const std::uint32_t bit = std::uint32_t(1) << stream;
+        if (!(replayFills & bit))
+            return false;
+        replayFills &= ~bit;
+        return replayPC == instructionPC;
+    }
+
+    /* Version of the layout of saved state. State saved with another version
+    is rejected, so it changes with the layout */
+    static constexpr std::uint16_t stateVersion = 1;
+
+    /* Appends the architectural state of the unit to out: stream registers
+    with their descriptors and the progress of their streams, predicates, EOD
+    flags and the retry of an instruction that trapped halfway. Counters, the
+    descriptor cache and the timing model are not part of it. Registers and
+    predicates still as left by reset are skipped, so an idle unit only saves a
+    short header. A checkpoint can append the unit to its own data, and a
+    context switch that keeps out around saves without allocating */
+    void saveState(std::vector<std::uint8_t> &out) const;
+
+    /* Restores state saved by saveState, and returns how many bytes of in it
+    took. State of another version or register length, or that is malformed,
+    is rejected with 0, leaving the unit reset */
+    size_t restoreState(std::span<const std::uint8_t> in);
+
+    /* Returns every register and predicate to its state after construction.
+    Counters and the register length are kept */
+    void reset();
+
+    /* Optional Streaming Engine timing model, see streaming_timing.h */
+    std::optional<streamTiming_t> timing;
+
+    void enableTiming(size_t fifoDepth, size_t bandwidth, size_t latency);
+
+    void retireInstruction() {
+        if (timing)
+            timing->retire();
+    }
+
+    /* Stall cycles estimated since the previous call */
+    std::uint64_t takeStallCycles() {
+        return timing ? timing->takeStallCycles() : 0;
+    }
+    std::uint64_t readEvent(std::uint64_t event) const;
+    /* Writes the counters as a JSON object */
+    void dumpStats(FILE *out) const;
 
-    void updateEODTable(const size_t stream);
+    bool isEndOfDimension(size_t stream, size_t dim) const {
+        return (EODTable[stream] >> dim) & 1;
+    }
 
     template <typename Operation>
     auto operateRegister(size_t streamRegister, Operation &&op) {
@@ -209,6 +568,49 @@ struct streamingUnit_t {
         assert_msg("Tried to use a predicate register index higher than the available predicate registers.", predRegister < predRegCount);
         return std::visit([op = std::move(op)](auto &reg) { return op(reg); }, predicates.at(predRegister));
     }
+
+private:
+    size_t registerLength = defaultRegisterLength;
+    Fp16Format fp16Format = Fp16Format::Half;
+    Fp8Format fp8Format = Fp8Format::E4M3;
+    std::uint64_t instructionPC = 0;
+    std::uint32_t instructionFills = 0;
+    std::uint64_t replayPC = 0;
+    std::uint32_t replayFills = 0;
+    static_assert(registerCount <= 32, "fill masks hold a bit per stream register");
+    /* Entry of configurationStats of the stream held by each register, if it
+    was configured by an instruction */
+    std::array<streamStats_t *, registerCount> configurations{};
+
+    /* Descriptors of replaced streams, by the PC of the instruction that
+    started configuring them. A stream configured again from the same PC picks
+    its descriptor up, so a loop re-configuring a stream only rebinds the base
+    address and dimension values. Direct-mapped */
+    struct cachedDescriptor_t {
+        std::optional<std::uint64_t> pc;
+        descriptorIterator_t descriptor;
+    };
+    static constexpr size_t configurationCacheSize = 16;
+    std::array<cachedDescriptor_t, configurationCacheSize> configurationCache;
+    std::array<std::optional<std::uint64_t>, registerCount> configuringPCs;
+
+    bool isIdle(size_t streamRegister) const;
+
+    static predRegister_t resetPredicate(size_t predRegister) {
+        return predRegister_t(predRegister ? predRegister_t::MaskType(0) : ~predRegister_t::MaskType(0));
+    }
+
+    cachedDescriptor_t &cachedDescriptor(std::uint64_t pc) {
+        return configurationCache[(pc >> 2) % configurationCacheSize];
+    }
+
+    template <typename T, typename Handler, typename... Indices>
+    void invokeWithWidth(Handler &handler, Indices... streamRegisters) {
+        if constexpr (std::is_invocable_v<Handler &, decltype((void)streamRegisters, std::declval<streamRegister_t<T> &>())...>)
+            handler(std::get<streamRegister_t<T>>(registers[streamRegisters])...);
+        else
+            assert_msg("Invoking instruction with invalid parameter sizes", false);
+    }
 };
 
 #endif // STREAMING_UNIT_HPP
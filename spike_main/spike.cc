@@ -50,6 +50,8 @@ static void help(int exit_code = 1)
   fprintf(stderr, "  --ic=<S>:<W>:<B>      Instantiate a cache model with S sets,\n");
   fprintf(stderr, "  --dc=<S>:<W>:<B>        W ways, and B-byte blocks (with S and\n");
   fprintf(stderr, "  --l2=<S>:<W>:<B>        B both powers of 2).\n");
+  fprintf(stderr, "  --dc-prefetch=<N>:<L> Prefetch the next N lines of affine UVE streams\n");
+  fprintf(stderr, "                          into the D$, arriving L accesses after issue\n");
   fprintf(stderr, "  --big-endian          Use a big-endian memory system.\n");
   fprintf(stderr, "  --misaligned          Support misaligned memory accesses\n");
   fprintf(stderr, "  --device=<name>       Attach MMIO plugin device from an --extlib library,\n");
@@ -87,6 +89,13 @@ static void help(int exit_code = 1)
   fprintf(stderr, "  --dm-no-abstractauto  Debug module won't support the abstractauto register\n");
   fprintf(stderr, "  --blocksz=<size>      Cache block size (B) for CMO operations(powers of 2) [default 64]\n");
   fprintf(stderr, "  --instructions=<n>    Stop after n instructions\n");
+  fprintf(stderr, "  --uve-vlen=<bytes>    UVE stream register length (powers of 2) [default %zu]\n", defaultRegisterLength);
+  fprintf(stderr, "  --uve-stats=<name>    Write UVE stream counters as JSON to <name> at exit\n");
+  fprintf(stderr, "  --uve-timing=<D>:<B>:<L> Estimate UVE stream stalls into mcycle, with\n");
+  fprintf(stderr, "                          D-chunk stream FIFOs and a memory port of\n");
+  fprintf(stderr, "                          B bytes/cycle and L cycles of latency\n");
+  fprintf(stderr, "  --uve-fp16=<ieee|bf16> Format of 16-bit UVE floating-point elements [default ieee]\n");
+  fprintf(stderr, "  --uve-fp8=<e4m3|e5m2> Format of 8-bit UVE floating-point elements [default e4m3]\n");
 
   exit(exit_code);
 }
@@ -256,6 +265,25 @@ static std::vector<mem_cfg_t> parse_mem_layout(const char* arg)
   return merged_mem;
 }
 
+static uve_timing_cfg_t parse_uve_timing(const char* arg)
+{
+  // <fifo depth>:<bytes per cycle>:<latency>
+  uve_timing_cfg_t timing;
+  char* p;
+  timing.fifo_depth = strtoull(arg, &p, 0);
+  if (*p != ':')
+    help();
+  timing.bandwidth = strtoull(p + 1, &p, 0);
+  if (*p != ':')
+    help();
+  timing.latency = strtoull(p + 1, &p, 0);
+  if (*p || !timing.fifo_depth || !timing.bandwidth) {
+    fprintf(stderr, "--uve-timing needs a non-zero FIFO depth and bandwidth\n");
+    exit(-1);
+  }
+  return timing;
+}
+
 static std::vector<std::pair<reg_t, abstract_mem_t*>> make_mems(const std::vector<mem_cfg_t> &layout)
 {
   std::vector<std::pair<reg_t, abstract_mem_t*>> mems;
@@ -331,6 +359,8 @@ int main(int argc, char** argv)
   std::unique_ptr<icache_sim_t> ic;
   std::unique_ptr<dcache_sim_t> dc;
   std::unique_ptr<cache_sim_t> l2;
+  size_t dc_prefetch_distance = 0;
+  size_t dc_prefetch_latency = 0;
   bool log_cache = false;
   bool log_commits = false;
   const char *log_path = nullptr;
@@ -389,6 +419,18 @@ int main(int argc, char** argv)
   parser.option(0, "ic", 1, [&](const char* s){ic.reset(new icache_sim_t(s));});
   parser.option(0, "dc", 1, [&](const char* s){dc.reset(new dcache_sim_t(s));});
   parser.option(0, "l2", 1, [&](const char* s){l2.reset(cache_sim_t::construct(s, "L2$"));});
+  parser.option(0, "dc-prefetch", 1, [&](const char* s){
+    // <lines ahead>:<latency in accesses>
+    char* p;
+    dc_prefetch_distance = strtoull(s, &p, 0);
+    if (*p != ':')
+      help();
+    dc_prefetch_latency = strtoull(p + 1, &p, 0);
+    if (*p || !dc_prefetch_distance) {
+      fprintf(stderr, "--dc-prefetch needs a non-zero number of lines\n");
+      exit(-1);
+    }
+  });
   parser.option(0, "big-endian", 0, [&](const char UNUSED *s){cfg.endianness = endianness_big;});
   parser.option(0, "misaligned", 0, [&](const char UNUSED *s){cfg.misaligned = true;});
   parser.option(0, "log-cache-miss", 0, [&](const char UNUSED *s){log_cache = true;});
@@ -462,6 +504,33 @@ int main(int argc, char** argv)
   parser.option(0, "instructions", 1, [&](const char* s){
     instructions = strtoull(s, 0, 0);
   });
+  parser.option(0, "uve-vlen", 1, [&](const char* s){
+    const reg_t vlen = strtoull(s, 0, 0);
+    if (vlen < minRegisterLength || vlen > maxRegisterLength || ((vlen & (vlen - 1))) != 0) {
+      fprintf(stderr, "--uve-vlen must be a power of 2 between %zu and %zu\n",
+        minRegisterLength, maxRegisterLength);
+      exit(-1);
+    }
+    cfg.uve_vlen = vlen;
+  });
+  parser.option(0, "uve-stats", 1, [&](const char* s){cfg.uve_stats_file = s;});
+  parser.option(0, "uve-timing", 1, [&](const char* s){cfg.uve_timing = parse_uve_timing(s);});
+  parser.option(0, "uve-fp16", 1, [&](const char* s){
+    const std::string format(s);
+    if (format != "ieee" && format != "bf16") {
+      fprintf(stderr, "--uve-fp16 must be ieee or bf16\n");
+      exit(-1);
+    }
+    cfg.uve_bf16 = format == "bf16";
+  });
+  parser.option(0, "uve-fp8", 1, [&](const char* s){
+    const std::string format(s);
+    if (format != "e4m3" && format != "e5m2") {
+      fprintf(stderr, "--uve-fp8 must be e4m3 or e5m2\n");
+      exit(-1);
+    }
+    cfg.uve_e5m2 = format == "e5m2";
+  });
 
   auto argv1 = parser.parse(argv);
   std::vector<std::string> htif_args(argv1, (const char*const*)argv + argc);
@@ -542,6 +611,7 @@ int main(int argc, char** argv)
   if (dc && l2) dc->set_miss_handler(&*l2);
   if (ic) ic->set_log(log_cache);
   if (dc) dc->set_log(log_cache);
+  if (dc && dc_prefetch_distance) dc->set_stream_prefetcher(dc_prefetch_distance, dc_prefetch_latency);
   for (size_t i = 0; i < cfg.nprocs(); i++)
   {
     if (ic) s.get_core(i)->get_mmu()->register_memtracer(&*ic);